@@ -3,11 +3,15 @@
 #define ROPUFU_SEQUENTIAL_GAUSSIAN_MEAN_HYPOTHESES_AGGREGATOR_HPP_INCLUDED
 
 #include <ropufu/algebra/matrix.hpp>
-#include <ropufu/probability/moment_statistic.hpp>
 
+#include "binary_archive.hpp"
+#include "kernels.hpp"
 #include "model.hpp"
+#include "moment_accumulator.hpp"
+#include "stopping_time_histogram.hpp"
 #include "xsprt.hpp"
 
+#include <array>       // std::array
 #include <concepts>    // std::floating_point
 #include <cstddef>     // std::size_t
 #include <functional>  // std::hash
@@ -16,30 +20,45 @@
 #include <string>      // std::string
 #include <string_view> // std::string_view
 #include <variant>     // std::variant, std::monostate, std::visit
+#include <utility>     // std::move
 #include <vector>      // std::vector
 
 namespace ropufu::sequential::gaussian_mean_hypotheses
 {
-    template <std::floating_point t_value_type>
+    template <std::floating_point t_value_type, xsprt_rule... t_extra_rule_types>
     struct aggregator
     {
-        using type = aggregator<t_value_type>;
+        using type = aggregator<t_value_type, t_extra_rule_types...>;
         using value_type = t_value_type;
         
-        using statistic_type = xsprt<value_type>;
+        using statistic_type = xsprt<value_type, t_extra_rule_types...>;
         using simulator_output_type = typename statistic_type::output_type;
+
+        static constexpr std::size_t count_extra_rules = statistic_type::count_extra_rules;
+
+        template <typename t_data_type>
+        using pair_t = xsprt_pair<t_data_type, count_extra_rules>;
+
+        /** Number of statistics kept for every rule: sample size, two error indicators, forced decisions, and stopping time distribution. */
+        static constexpr std::size_t count_statistics_per_rule = 5;
+        /** Number of independent parts an aggregator is merged in: statistics of every rule, then those of whole paths. */
+        static constexpr std::size_t count_merge_parts = count_statistics_per_rule * pair_t<std::size_t>::count_rules + 1;
         
         template <typename t_data_type>
         using matrix_t = ropufu::aftermath::algebra::matrix<t_data_type>;
-        using sample_size_type = ropufu::aftermath::probability::moment_statistic<
-            matrix_t<std::size_t>,
-            matrix_t<value_type>>;
-        using error_probability_type = ropufu::aftermath::probability::moment_statistic<matrix_t<value_type>>;
+        using sample_size_type = moment_accumulator<std::size_t, value_type>;
+        using error_probability_type = moment_accumulator<value_type, value_type>;
+        using stopping_time_distribution_type = stopping_time_histogram<value_type>;
 
     private:
-        xsprt_pair<sample_size_type> m_sample_size = {};
-        xsprt_pair<error_probability_type> m_direct_error_indicator = {};
-        xsprt_pair<error_probability_type> m_importance_error_indicator = {};
+        pair_t<sample_size_type> m_sample_size = {};
+        pair_t<error_probability_type> m_direct_error_indicator = {};
+        pair_t<error_probability_type> m_importance_error_indicator = {};
+        pair_t<error_probability_type> m_forced_decision_indicator = {};
+        pair_t<stopping_time_distribution_type> m_stopping_time_distribution = {};
+        stopping_time_distribution_type m_path_length_distribution = {1, 1};
+        std::size_t m_count_truncated_paths = 0;
+        std::size_t m_longest_path = 0;
         std::size_t m_height = 0;
         std::size_t m_width = 0;
         value_type m_anticipated_sample_size = 0;
@@ -57,9 +76,19 @@ namespace ropufu::sequential::gaussian_mean_hypotheses
 
             matrix_t<value_type> zero = matrix_t<value_type>(height, width);
             matrix_t<value_type> x = matrix_t<value_type>(height, width, anticipated_sample_size);
-            this->m_sample_size = {sample_size_type(x), sample_size_type(x)};
-            this->m_direct_error_indicator = {error_probability_type(zero), error_probability_type(zero)};
-            this->m_importance_error_indicator = {error_probability_type(zero), error_probability_type(zero)};
+            this->m_sample_size = {sample_size_type(x), sample_size_type(x), {}};
+            this->m_direct_error_indicator = {error_probability_type(zero), error_probability_type(zero), {}};
+            this->m_importance_error_indicator = {error_probability_type(zero), error_probability_type(zero), {}};
+            this->m_forced_decision_indicator = {error_probability_type(zero), error_probability_type(zero), {}};
+            this->m_stopping_time_distribution = {stopping_time_distribution_type(height, width), stopping_time_distribution_type(height, width), {}};
+            for (std::size_t k = 0; k < count_extra_rules; ++k)
+            {
+                this->m_sample_size.extra_rules[k] = sample_size_type(x);
+                this->m_direct_error_indicator.extra_rules[k] = error_probability_type(zero);
+                this->m_importance_error_indicator.extra_rules[k] = error_probability_type(zero);
+                this->m_forced_decision_indicator.extra_rules[k] = error_probability_type(zero);
+                this->m_stopping_time_distribution.extra_rules[k] = stopping_time_distribution_type(height, width);
+            } // for (...)
         } // initialize(...)
 
     public:
@@ -67,13 +96,37 @@ namespace ropufu::sequential::gaussian_mean_hypotheses
         {
         } // aggregator(...)
 
-        const xsprt_pair<sample_size_type>& sample_size() const noexcept { return this->m_sample_size; }
+        const pair_t<sample_size_type>& sample_size() const noexcept { return this->m_sample_size; }
+
+        const pair_t<error_probability_type>& direct_error_indicator() const noexcept { return this->m_direct_error_indicator; }
+
+        const pair_t<error_probability_type>& importance_error_indicator() const noexcept { return this->m_importance_error_indicator; }
+
+        /** Fraction of paths in which the decision of every cell was forced by truncation. */
+        const pair_t<error_probability_type>& forced_decision_indicator() const noexcept { return this->m_forced_decision_indicator; }
 
-        const xsprt_pair<error_probability_type>& direct_error_indicator() const noexcept { return this->m_direct_error_indicator; }
+        /** Histograms of stopping times in every cell, for tail quantiles of the sample size. */
+        const pair_t<stopping_time_distribution_type>& stopping_time_distribution() const noexcept { return this->m_stopping_time_distribution; }
 
-        const xsprt_pair<error_probability_type>& importance_error_indicator() const noexcept { return this->m_importance_error_indicator; }
+        /** Histogram of the number of observations per path, i.e. until the last rule stopped or the path was truncated. */
+        const stopping_time_distribution_type& path_length_distribution() const noexcept { return this->m_path_length_distribution; }
 
+        /** Number of paths truncated before every rule stopped. */
+        std::size_t count_truncated_paths() const noexcept { return this->m_count_truncated_paths; }
+
+        std::size_t longest_path() const noexcept { return this->m_longest_path; }
+
+        /** Number of simulated paths. */
+        std::size_t count_paths() const noexcept { return this->m_path_length_distribution.count(); }
+
+        /** Adds the path \p value; the update is built for the selected instruction set. */
         void operator()(const simulator_output_type& value)
+        {
+            kernels::run<value_type>([this, &value] () { this->observe_path(value); });
+        } // operator ()(...)
+
+    private:
+        void observe_path(const simulator_output_type& value)
         {
             if (this->empty()) this->initialize(value.height(), value.width(), value.anticipated_sample_size);
 
@@ -85,21 +138,105 @@ namespace ropufu::sequential::gaussian_mean_hypotheses
 
             this->m_importance_error_indicator.adaptive_sprt.observe(value.importance_error_indicator.adaptive_sprt);
             this->m_importance_error_indicator.generalized_sprt.observe(value.importance_error_indicator.generalized_sprt);
-        } // operator ()(...)
 
-        void operator()(const type& other)
+            this->m_forced_decision_indicator.adaptive_sprt.observe(value.forced_decision_indicator.adaptive_sprt);
+            this->m_forced_decision_indicator.generalized_sprt.observe(value.forced_decision_indicator.generalized_sprt);
+
+            this->m_stopping_time_distribution.adaptive_sprt.observe(value.when_stopped.adaptive_sprt);
+            this->m_stopping_time_distribution.generalized_sprt.observe(value.when_stopped.generalized_sprt);
+
+            for (std::size_t k = 0; k < count_extra_rules; ++k)
+            {
+                this->m_sample_size.extra_rules[k].observe(value.when_stopped.extra_rules[k]);
+                this->m_direct_error_indicator.extra_rules[k].observe(value.direct_error_indicator.extra_rules[k]);
+                this->m_importance_error_indicator.extra_rules[k].observe(value.importance_error_indicator.extra_rules[k]);
+                this->m_forced_decision_indicator.extra_rules[k].observe(value.forced_decision_indicator.extra_rules[k]);
+                this->m_stopping_time_distribution.extra_rules[k].observe(value.when_stopped.extra_rules[k]);
+            } // for (...)
+
+            this->m_path_length_distribution.observe(value.path_length);
+            if (value.is_truncated) ++this->m_count_truncated_paths;
+            if (value.path_length > this->m_longest_path) this->m_longest_path = value.path_length;
+        } // observe_path(...)
+
+    public:
+        /** Readies this aggregator to have \p other merged into it, part by part. */
+        void prepare_merge(const type& other) noexcept
         {
             if (this->empty()) this->initialize(other.m_height, other.m_width, other.m_anticipated_sample_size);
+        } // prepare_merge(...)
 
-            this->m_sample_size.adaptive_sprt.observe(other.m_sample_size.adaptive_sprt);
-            this->m_sample_size.generalized_sprt.observe(other.m_sample_size.generalized_sprt);
-
-            this->m_direct_error_indicator.adaptive_sprt.observe(other.m_direct_error_indicator.adaptive_sprt);
-            this->m_direct_error_indicator.generalized_sprt.observe(other.m_direct_error_indicator.generalized_sprt);
+        /** @brief Merges part \p part, out of \c count_merge_parts, of \p other into this aggregator.
+         *  @details Parts touch disjoint statistics: once \c prepare_merge has been called, different parts may be merged concurrently.
+         *  Merging every part is the same as merging \p other as a whole.
+         */
+        void merge_part(const type& other, std::size_t part)
+        {
+            std::size_t rule = part / type::count_statistics_per_rule;
+            if (rule == pair_t<std::size_t>::count_rules)
+            {
+                this->m_path_length_distribution.merge(other.m_path_length_distribution);
+                this->m_count_truncated_paths += other.m_count_truncated_paths;
+                if (other.m_longest_path > this->m_longest_path) this->m_longest_path = other.m_longest_path;
+                return;
+            } // if (...)
+            switch (part % type::count_statistics_per_rule)
+            {
+            case 0: this->m_sample_size.rule(rule).observe(other.m_sample_size.rule(rule)); break;
+            case 1: this->m_direct_error_indicator.rule(rule).observe(other.m_direct_error_indicator.rule(rule)); break;
+            case 2: this->m_importance_error_indicator.rule(rule).observe(other.m_importance_error_indicator.rule(rule)); break;
+            case 3: this->m_forced_decision_indicator.rule(rule).observe(other.m_forced_decision_indicator.rule(rule)); break;
+            default: this->m_stopping_time_distribution.rule(rule).merge(other.m_stopping_time_distribution.rule(rule)); break;
+            } // switch (...)
+        } // merge_part(...)
 
-            this->m_importance_error_indicator.adaptive_sprt.observe(other.m_importance_error_indicator.adaptive_sprt);
-            this->m_importance_error_indicator.generalized_sprt.observe(other.m_importance_error_indicator.generalized_sprt);
+        void operator()(const type& other)
+        {
+            this->prepare_merge(other);
+            for (std::size_t part = 0; part < type::count_merge_parts; ++part) this->merge_part(other, part);
         } // operator ()(...)
+
+        void write(binary_writer& writer) const
+        {
+            writer.write_size(this->m_height);
+            writer.write_size(this->m_width);
+            writer.write(this->m_anticipated_sample_size);
+            for (std::size_t rule = 0; rule < pair_t<std::size_t>::count_rules; ++rule)
+            {
+                this->m_sample_size.rule(rule).write(writer);
+                this->m_direct_error_indicator.rule(rule).write(writer);
+                this->m_importance_error_indicator.rule(rule).write(writer);
+                this->m_forced_decision_indicator.rule(rule).write(writer);
+                this->m_stopping_time_distribution.rule(rule).write(writer);
+            } // for (...)
+            this->m_path_length_distribution.write(writer);
+            writer.write_size(this->m_count_truncated_paths);
+            writer.write_size(this->m_longest_path);
+        } // write(...)
+
+        /** @exception std::runtime_error Stream ended early, or the stored statistics are inconsistent. */
+        void read(binary_reader& reader)
+        {
+            type result{};
+            result.m_height = reader.read_size();
+            result.m_width = reader.read_size();
+            reader.read(result.m_anticipated_sample_size);
+            for (std::size_t rule = 0; rule < pair_t<std::size_t>::count_rules; ++rule)
+            {
+                result.m_sample_size.rule(rule).read(reader);
+                result.m_direct_error_indicator.rule(rule).read(reader);
+                result.m_importance_error_indicator.rule(rule).read(reader);
+                result.m_forced_decision_indicator.rule(rule).read(reader);
+                result.m_stopping_time_distribution.rule(rule).read(reader);
+            } // for (...)
+            result.m_path_length_distribution.read(reader);
+            if (result.m_path_length_distribution.height() != 1 || result.m_path_length_distribution.width() != 1)
+                throw std::runtime_error("Stored path lengths must form a single histogram.");
+            result.m_count_truncated_paths = reader.read_size();
+            result.m_longest_path = reader.read_size();
+
+            *this = std::move(result);
+        } // read(...)
     }; // struct aggregator
 } // namespace ropufu::sequential::gaussian_mean_hypotheses
 
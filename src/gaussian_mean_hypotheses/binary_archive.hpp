@@ -0,0 +1,154 @@
+
+#ifndef ROPUFU_SEQUENTIAL_GAUSSIAN_MEAN_HYPOTHESES_BINARY_ARCHIVE_HPP_INCLUDED
+#define ROPUFU_SEQUENTIAL_GAUSSIAN_MEAN_HYPOTHESES_BINARY_ARCHIVE_HPP_INCLUDED
+
+#include <ropufu/algebra/matrix.hpp>
+
+#include <cstddef>     // std::size_t
+#include <cstdint>     // std::uint64_t
+#include <istream>     // std::istream
+#include <ostream>     // std::ostream
+#include <stdexcept>   // std::runtime_error
+#include <string>      // std::string
+#include <string_view> // std::string_view
+#include <type_traits> // std::is_trivially_copyable_v
+#include <vector>      // std::vector
+
+namespace ropufu::sequential::gaussian_mean_hypotheses
+{
+    /** @brief Writes values in their in-memory representation, to be read back by \c binary_reader on the same platform.
+     *  @details Sizes are always written as 64-bit integers.
+     */
+    struct binary_writer
+    {
+        using type = binary_writer;
+
+        template <typename t_data_type>
+        using matrix_t = ropufu::aftermath::algebra::matrix<t_data_type>;
+
+    private:
+        std::ostream& m_stream;
+
+    public:
+        explicit binary_writer(std::ostream& stream) noexcept
+            : m_stream(stream)
+        {
+        } // binary_writer(...)
+
+        /** Indicates that everything so far has been written successfully. */
+        bool good() const noexcept { return this->m_stream.good(); }
+
+        template <typename t_data_type>
+            requires std::is_trivially_copyable_v<t_data_type>
+        void write(const t_data_type& value)
+        {
+            this->m_stream.write(reinterpret_cast<const char*>(&value), sizeof(t_data_type));
+        } // write(...)
+
+        void write_size(std::size_t value)
+        {
+            this->write(static_cast<std::uint64_t>(value));
+        } // write_size(...)
+
+        void write_string(std::string_view value)
+        {
+            this->write_size(value.size());
+            this->m_stream.write(value.data(), static_cast<std::streamsize>(value.size()));
+        } // write_string(...)
+
+        template <typename t_data_type>
+        void write_vector(const std::vector<t_data_type>& value)
+        {
+            this->write_size(value.size());
+            for (const t_data_type& x : value) this->write(x);
+        } // write_vector(...)
+
+        template <typename t_data_type>
+        void write_matrix(const matrix_t<t_data_type>& value)
+        {
+            this->write_size(value.height());
+            this->write_size(value.width());
+            for (std::size_t i = 0; i < value.height(); ++i)
+                for (std::size_t j = 0; j < value.width(); ++j)
+                    this->write(value(i, j));
+        } // write_matrix(...)
+    }; // struct binary_writer
+
+    /** @brief Reads values written by \c binary_writer.
+     *  @details Every read throws \c std::runtime_error if the stream ends early or a size is implausible.
+     */
+    struct binary_reader
+    {
+        using type = binary_reader;
+
+        template <typename t_data_type>
+        using matrix_t = ropufu::aftermath::algebra::matrix<t_data_type>;
+
+        /** Largest number of elements a single string, vector, or matrix may hold. */
+        static constexpr std::size_t max_count = std::size_t(1) << 32;
+
+    private:
+        std::istream& m_stream;
+
+    public:
+        explicit binary_reader(std::istream& stream) noexcept
+            : m_stream(stream)
+        {
+        } // binary_reader(...)
+
+        /** @exception std::runtime_error Stream ended. */
+        template <typename t_data_type>
+            requires std::is_trivially_copyable_v<t_data_type>
+        void read(t_data_type& value)
+        {
+            this->m_stream.read(reinterpret_cast<char*>(&value), sizeof(t_data_type));
+            if (!this->m_stream) throw std::runtime_error("Unexpected end of stream.");
+        } // read(...)
+
+        /** @exception std::runtime_error Stream ended, or the size is implausible. */
+        std::size_t read_size()
+        {
+            std::uint64_t value = 0;
+            this->read(value);
+            if (value > type::max_count) throw std::runtime_error("Size out of range.");
+            return static_cast<std::size_t>(value);
+        } // read_size(...)
+
+        /** @exception std::runtime_error Stream ended, or the size is implausible. */
+        void read_string(std::string& value)
+        {
+            value.resize(this->read_size());
+            this->m_stream.read(value.data(), static_cast<std::streamsize>(value.size()));
+            if (!this->m_stream) throw std::runtime_error("Unexpected end of stream.");
+        } // read_string(...)
+
+        /** @exception std::runtime_error Stream ended, or the size is implausible. */
+        template <typename t_data_type>
+        void read_vector(std::vector<t_data_type>& value)
+        {
+            std::size_t size = this->read_size();
+            value.clear();
+            for (std::size_t k = 0; k < size; ++k)
+            {
+                t_data_type x{};
+                this->read(x);
+                value.push_back(x);
+            } // for (...)
+        } // read_vector(...)
+
+        /** @exception std::runtime_error Stream ended, or the size is implausible. */
+        template <typename t_data_type>
+        void read_matrix(matrix_t<t_data_type>& value)
+        {
+            std::size_t height = this->read_size();
+            std::size_t width = this->read_size();
+            if (height != 0 && width > type::max_count / height) throw std::runtime_error("Size out of range.");
+            value = matrix_t<t_data_type>(height, width);
+            for (std::size_t i = 0; i < height; ++i)
+                for (std::size_t j = 0; j < width; ++j)
+                    this->read(value(i, j));
+        } // read_matrix(...)
+    }; // struct binary_reader
+} // namespace ropufu::sequential::gaussian_mean_hypotheses
+
+#endif // ROPUFU_SEQUENTIAL_GAUSSIAN_MEAN_HYPOTHESES_BINARY_ARCHIVE_HPP_INCLUDED
@@ -0,0 +1,615 @@
+
+#ifndef ROPUFU_SEQUENTIAL_GAUSSIAN_MEAN_HYPOTHESES_CALIBRATION_HPP_INCLUDED
+#define ROPUFU_SEQUENTIAL_GAUSSIAN_MEAN_HYPOTHESES_CALIBRATION_HPP_INCLUDED
+
+#include <nlohmann/json.hpp>
+#include <ropufu/noexcept_json.hpp>
+
+#include <ropufu/random/standard_normal_sampler_512.hpp>
+#include <ropufu/sequential/iid_process.hpp>
+#include <ropufu/sequential/parallel_stopping_time.hpp>
+
+#include "kernels.hpp"
+#include "model.hpp"
+#include "xsprt.hpp"
+
+#include <algorithm>   // std::partition_point, std::clamp
+#include <array>       // std::array
+#include <cmath>       // std::exp, std::log, std::sqrt, std::abs
+#include <concepts>    // std::floating_point
+#include <cstddef>     // std::size_t
+#include <limits>      // std::numeric_limits
+#include <optional>    // std::optional, std::nullopt
+#include <random>      // std::seed_seq
+#include <span>        // std::span
+#include <stdexcept>   // std::runtime_error
+#include <string>      // std::string
+#include <string_view> // std::string_view
+#include <utility>     // std::pair
+#include <vector>      // std::vector
+
+#ifdef ROPUFU_TMP_TYPENAME
+#undef ROPUFU_TMP_TYPENAME
+#endif
+#ifdef ROPUFU_TMP_TEMPLATE_SIGNATURE
+#undef ROPUFU_TMP_TEMPLATE_SIGNATURE
+#endif
+#define ROPUFU_TMP_TYPENAME calibration_settings<t_value_type>
+#define ROPUFU_TMP_TEMPLATE_SIGNATURE template <std::floating_point t_value_type>
+
+namespace ropufu::sequential::gaussian_mean_hypotheses
+{
+    ROPUFU_TMP_TEMPLATE_SIGNATURE
+    struct calibration_settings;
+
+    ROPUFU_TMP_TEMPLATE_SIGNATURE
+    void to_json(nlohmann::json& j, const ROPUFU_TMP_TYPENAME& x) noexcept;
+    ROPUFU_TMP_TEMPLATE_SIGNATURE
+    void from_json(const nlohmann::json& j, ROPUFU_TMP_TYPENAME& x);
+
+    /** Target error probabilities for threshold calibration. */
+    ROPUFU_TMP_TEMPLATE_SIGNATURE
+    struct calibration_settings
+    {
+        using type = ROPUFU_TMP_TYPENAME;
+        using value_type = t_value_type;
+
+        // ~~ Json names ~~
+        static constexpr std::string_view jstr_false_alarm = "false alarm";
+        static constexpr std::string_view jstr_missed_detection = "missed detection";
+        static constexpr std::string_view jstr_relative_tolerance = "relative tolerance";
+        static constexpr std::string_view jstr_max_simulations = "max simulations";
+        static constexpr std::string_view jstr_max_memory = "max memory";
+
+        friend ropufu::noexcept_json_serializer<type>;
+
+    private:
+        value_type m_false_alarm = 0;
+        value_type m_missed_detection = 0;
+        value_type m_relative_tolerance = static_cast<value_type>(0.1);
+        std::size_t m_max_simulations = 1'000'000;
+        std::size_t m_max_memory = 4'096; // In megabytes.
+
+        /** @brief Validates the structure and returns an error message, if any. */
+        std::optional<std::string> error_message() const noexcept
+        {
+            if (this->empty()) return std::nullopt;
+            if (!(this->m_false_alarm > 0 && this->m_false_alarm < 1)) return "False alarm probability must be in (0, 1).";
+            if (!(this->m_missed_detection > 0 && this->m_missed_detection < 1)) return "Missed detection probability must be in (0, 1).";
+            if (!(this->m_relative_tolerance > 0)) return "Relative tolerance must be positive.";
+            if (this->m_max_memory == 0) return "Max memory must be positive.";
+
+            return std::nullopt;
+        } // error_message(...)
+
+    public:
+        calibration_settings() noexcept = default;
+
+        bool empty() const noexcept { return this->m_false_alarm == 0 && this->m_missed_detection == 0; }
+
+        value_type false_alarm() const noexcept { return this->m_false_alarm; }
+
+        value_type missed_detection() const noexcept { return this->m_missed_detection; }
+
+        /** Largest acceptable ratio of standard error to estimated error probability. */
+        value_type relative_tolerance() const noexcept { return this->m_relative_tolerance; }
+
+        /** Upper bound on the number of simulations per hypothesis. */
+        std::size_t max_simulations() const noexcept { return this->m_max_simulations; }
+
+        /** @brief Upper bound, in megabytes, on the memory taken by the recorded paths of both hypotheses.
+         *  @details Every recorded path is kept until calibration ends; a path takes a few hundred bytes per rule.
+         */
+        std::size_t max_memory() const noexcept { return this->m_max_memory; }
+
+        friend void to_json(nlohmann::json& j, const type& x) noexcept
+        {
+            j = nlohmann::json{
+                {type::jstr_false_alarm, x.m_false_alarm},
+                {type::jstr_missed_detection, x.m_missed_detection},
+                {type::jstr_relative_tolerance, x.m_relative_tolerance},
+                {type::jstr_max_simulations, x.m_max_simulations},
+                {type::jstr_max_memory, x.m_max_memory}
+            };
+        } // to_json(...)
+
+        friend void from_json(const nlohmann::json& j, type& x)
+        {
+            if (!ropufu::noexcept_json::try_get(j, x))
+                throw std::runtime_error("Parsing <calibration_settings> failed: " + j.dump());
+        } // from_json(...)
+    }; // struct calibration_settings
+
+    /** Observation at which a statistic exceeded all of its previous values. */
+    template <std::floating_point t_value_type>
+    struct ladder_point
+    {
+        std::size_t time;
+        t_value_type statistic;
+        /** Log-likelihood ratio between the simulated and the change of measure signal strengths. */
+        t_value_type change_of_measure;
+    }; // struct ladder_point
+
+    /** @brief Ascending ladders of both statistics of one rule along one path.
+     *  @details Recording stops as soon as either statistic reaches its cap, so the stopping time and
+     *  decision of every threshold pair below the caps can be recovered without resimulating the path.
+     *  Points below the floors are never recorded: no threshold in the search range can be first crossed there.
+     *  If the path is truncated first, the ladders are censored: thresholds neither of them reaches
+     *  get the forced decision of the truncated rule.
+     *  The points themselves are owned elsewhere: by the simulator while recording, and by the aggregator afterwards.
+     */
+    template <std::floating_point t_value_type>
+    struct rule_ladder
+    {
+        using value_type = t_value_type;
+        using point_type = ladder_point<value_type>;
+
+        /** Statistic against the alternative: crossing leads to \c decide_vertical. */
+        std::span<const point_type> vertical;
+        /** Statistic against the null: crossing leads to \c decide_horizontal. */
+        std::span<const point_type> horizontal;
+        /** Number of observations when the path was truncated before either cap was reached; zero if it was not. */
+        std::size_t truncated_at = 0;
+        /** Statistics (against the alternative, against the null) when the path was truncated. */
+        std::pair<value_type, value_type> truncated_statistic = {};
+        /** Change of measure when the path was truncated. */
+        value_type truncated_change_of_measure = 0;
+
+        /** First point of \p ladder at or above \p threshold, if any. */
+        static const point_type* first_crossing(std::span<const point_type> ladder, value_type threshold) noexcept
+        {
+            auto search = std::partition_point(ladder.begin(), ladder.end(),
+                [threshold] (const point_type& p) { return p.statistic < threshold; });
+            return (search == ladder.end()) ? nullptr : &(*search);
+        } // first_crossing(...)
+    }; // struct rule_ladder
+
+    /** Recorded ladders of every rule along one simulated path. */
+    template <std::floating_point t_value_type, std::size_t t_count_extra_rules>
+    using calibration_path = xsprt_pair<rule_ladder<t_value_type>, t_count_extra_rules>;
+
+    /** Simulates paths once, recording enough of every rule's trajectory to evaluate any thresholds between the floors and the caps. */
+    template <std::floating_point t_value_type, typename t_engine_type, xsprt_rule... t_extra_rule_types>
+    struct calibration_simulator
+    {
+        using type = calibration_simulator<t_value_type, t_engine_type, t_extra_rule_types...>;
+        using value_type = t_value_type;
+        using engine_type = t_engine_type;
+
+        using sampler_type = ropufu::aftermath::random::standard_normal_sampler_512<engine_type, value_type>;
+        using process_type = ropufu::aftermath::sequential::iid_process<sampler_type>;
+        using statistic_type = xsprt<value_type, t_extra_rule_types...>;
+        using thresholds_type = typename statistic_type::thresholds_type;
+        using point_type = ladder_point<value_type>;
+
+        static constexpr std::size_t count_extra_rules = statistic_type::count_extra_rules;
+        static constexpr std::size_t count_rules = 2 + count_extra_rules;
+
+        using output_type = calibration_path<value_type, count_extra_rules>;
+        using caps_type = xsprt_pair<std::pair<value_type, value_type>, count_extra_rules>;
+
+        static constexpr std::size_t block_size = 100;
+
+    private:
+        process_type m_noise = {};
+        statistic_type m_statistic = {};
+        caps_type m_floors = {};
+        caps_type m_caps = {};
+        /** Reusable storage of the vertical (even) and horizontal (odd) ladder of every rule. */
+        std::array<std::vector<point_type>, 2 * count_rules> m_ladder_points = {};
+
+        /** @return True if the ladders still need to be recorded. */
+        static bool record(std::vector<point_type>& vertical, std::vector<point_type>& horizontal,
+            const std::pair<value_type, value_type>& floors, const std::pair<value_type, value_type>& caps,
+            const std::pair<value_type, value_type>& statistic, std::size_t time, value_type change_of_measure) noexcept
+        {
+            if (statistic.first >= floors.first && (vertical.empty() || statistic.first > vertical.back().statistic))
+                vertical.push_back({time, statistic.first, change_of_measure});
+            if (statistic.second >= floors.second && (horizontal.empty() || statistic.second > horizontal.back().statistic))
+                horizontal.push_back({time, statistic.second, change_of_measure});
+            return statistic.first < caps.first && statistic.second < caps.second;
+        } // record(...)
+
+    public:
+        calibration_simulator() noexcept = default;
+
+        /** @param floors Smallest thresholds (vertical, horizontal) of every rule that will be evaluated.
+         *  @param caps Largest thresholds (vertical, horizontal) of every rule that will be evaluated.
+         */
+        calibration_simulator(const statistic_type& statistic, const caps_type& floors, const caps_type& caps)
+            : m_statistic(statistic), m_floors(floors), m_caps(caps)
+        {
+            // Ladders are recorded from the statistics alone; none of the grids is needed.
+            this->m_statistic.track_statistics_only(true);
+
+            // A ladder gains at most one point per observation.
+            std::size_t capacity = static_cast<std::size_t>(std::ceil(this->m_statistic.anticipated_sample_size()));
+            if (this->m_statistic.max_sample_size() != 0 && capacity > this->m_statistic.max_sample_size())
+                capacity = this->m_statistic.max_sample_size();
+            for (std::vector<point_type>& points : this->m_ladder_points) points.reserve(capacity);
+        } // calibration_simulator(...)
+
+        void seed(std::seed_seq& sequence) noexcept
+        {
+            this->m_noise.seed(sequence);
+        } // seed(...)
+
+        /** @brief Simulates one path, built for the selected instruction set.
+         *  @return Ladders viewing storage of this simulator, valid until the next call.
+         */
+        output_type operator ()() noexcept
+        {
+            return kernels::run<value_type>([this] () noexcept { return this->record_path(); });
+        } // operator ()(...)
+
+    private:
+        output_type record_path() noexcept
+        {
+            using observation_container_type = typename process_type::container_type;
+
+            const auto& model = this->m_statistic.model();
+            value_type signal_strength = this->m_statistic.simulated_signal_strength();
+
+            this->m_noise.clear();
+            this->m_statistic.reset();
+            for (std::vector<point_type>& points : this->m_ladder_points) points.clear();
+
+            output_type result{};
+            std::array<bool, count_rules> is_recording{};
+            is_recording.fill(true);
+            std::size_t count_recording = count_rules;
+
+            const std::size_t count_channels = model.count_channels();
+            const std::size_t max_sample_size = (this->m_statistic.max_sample_size() == 0) ?
+                std::numeric_limits<std::size_t>::max() : this->m_statistic.max_sample_size();
+            observation_container_type block = observation_container_type(type::block_size * count_channels);
+            std::size_t time = 0;
+            signal_phase phase = {};
+            while (count_recording != 0 && time != max_sample_size)
+            {
+                this->m_noise.next(block);
+                for (std::size_t offset = 0; offset < block.size(); offset += count_channels)
+                {
+                    ++time;
+                    if (model.is_multichannel())
+                    {
+                        std::span<value_type> row{block.data() + offset, count_channels};
+                        model.channels().add_to(phase, signal_strength, row);
+                        model.channels().advance(phase);
+                        this->m_statistic.observe(row, model.channels());
+                    } // if (...)
+                    else
+                    {
+                        this->m_statistic.observe(block[offset] + signal_strength * model.signal().at(phase));
+                        model.signal().advance(phase);
+                    } // else (...)
+                    const auto& statistic = this->m_statistic.latest_statistic();
+                    value_type change_of_measure = this->m_statistic.latest_change_of_measure();
+
+                    for (std::size_t k = 0; k < count_rules; ++k)
+                    {
+                        if (!is_recording[k]) continue;
+                        if (type::record(this->m_ladder_points[2 * k], this->m_ladder_points[2 * k + 1],
+                            this->m_floors.rule(k), this->m_caps.rule(k), statistic.rule(k), time, change_of_measure)) continue;
+                        is_recording[k] = false;
+                        --count_recording;
+                    } // for (...)
+                    if (count_recording == 0 || time == max_sample_size) break;
+                } // for (...)
+            } // while (...)
+
+            const auto& statistic = this->m_statistic.latest_statistic();
+            value_type change_of_measure = this->m_statistic.latest_change_of_measure();
+            for (std::size_t k = 0; k < count_rules; ++k)
+            {
+                rule_ladder<value_type>& ladder = result.rule(k);
+                ladder.vertical = this->m_ladder_points[2 * k];
+                ladder.horizontal = this->m_ladder_points[2 * k + 1];
+                // Censor the ladders still being recorded when the path was truncated.
+                if (!is_recording[k]) continue;
+                ladder.truncated_at = time;
+                ladder.truncated_statistic = statistic.rule(k);
+                ladder.truncated_change_of_measure = change_of_measure;
+            } // for (...)
+
+            return result;
+        } // record_path(...)
+    }; // struct calibration_simulator
+
+    /** @brief Pools recorded paths across threads and batches.
+     *  @details Ladder points of all paths share one arena; each path keeps only offsets into it.
+     */
+    template <std::floating_point t_value_type, std::size_t t_count_extra_rules>
+    struct calibration_aggregator
+    {
+        using type = calibration_aggregator<t_value_type, t_count_extra_rules>;
+        using value_type = t_value_type;
+        using point_type = ladder_point<value_type>;
+        using ladder_type = rule_ladder<value_type>;
+        using path_type = calibration_path<value_type, t_count_extra_rules>;
+
+    private:
+        struct ladder_record
+        {
+            std::size_t offset;
+            std::size_t count_vertical;
+            std::size_t count_horizontal;
+            std::size_t truncated_at;
+            std::pair<value_type, value_type> truncated_statistic;
+            value_type truncated_change_of_measure;
+        }; // struct ladder_record
+
+        using record_type = xsprt_pair<ladder_record, t_count_extra_rules>;
+
+        std::vector<point_type> m_points = {};
+        std::vector<record_type> m_paths = {};
+
+    public:
+        calibration_aggregator() noexcept
+        {
+        } // calibration_aggregator(...)
+
+        std::size_t count() const noexcept { return this->m_paths.size(); }
+
+        /** Number of bytes taken by the recorded paths. */
+        std::size_t memory_usage() const noexcept
+        {
+            return this->m_points.capacity() * sizeof(point_type) + this->m_paths.capacity() * sizeof(record_type);
+        } // memory_usage(...)
+
+        /** Ladder of the rule with index \p rule_index along the path with index \p path_index. */
+        ladder_type ladder(std::size_t path_index, std::size_t rule_index) const noexcept
+        {
+            const ladder_record& x = this->m_paths[path_index].rule(rule_index);
+            const point_type* first = this->m_points.data() + x.offset;
+            ladder_type result{};
+            result.vertical = {first, x.count_vertical};
+            result.horizontal = {first + x.count_vertical, x.count_horizontal};
+            result.truncated_at = x.truncated_at;
+            result.truncated_statistic = x.truncated_statistic;
+            result.truncated_change_of_measure = x.truncated_change_of_measure;
+            return result;
+        } // ladder(...)
+
+        void operator()(const path_type& value)
+        {
+            record_type& x = this->m_paths.emplace_back();
+            for (std::size_t k = 0; k < path_type::count_rules; ++k)
+            {
+                const ladder_type& ladder = value.rule(k);
+                x.rule(k) = {this->m_points.size(), ladder.vertical.size(), ladder.horizontal.size(),
+                    ladder.truncated_at, ladder.truncated_statistic, ladder.truncated_change_of_measure};
+                this->m_points.insert(this->m_points.end(), ladder.vertical.begin(), ladder.vertical.end());
+                this->m_points.insert(this->m_points.end(), ladder.horizontal.begin(), ladder.horizontal.end());
+            } // for (...)
+        } // operator ()(...)
+
+        void operator()(const type& other)
+        {
+            std::size_t shift = this->m_points.size();
+            this->m_points.insert(this->m_points.end(), other.m_points.begin(), other.m_points.end());
+            this->m_paths.reserve(this->m_paths.size() + other.m_paths.size());
+            for (record_type x : other.m_paths)
+            {
+                for (std::size_t k = 0; k < path_type::count_rules; ++k) x.rule(k).offset += shift;
+                this->m_paths.push_back(x);
+            } // for (...)
+        } // operator ()(...)
+    }; // struct calibration_aggregator
+
+    /** Estimate with its standard error. */
+    template <std::floating_point t_value_type>
+    struct estimate
+    {
+        t_value_type value;
+        t_value_type standard_error;
+
+        t_value_type lower(t_value_type z) const noexcept { return this->value - z * this->standard_error; }
+        t_value_type upper(t_value_type z) const noexcept { return this->value + z * this->standard_error; }
+    }; // struct estimate
+
+    template <std::floating_point t_value_type>
+    struct calibration_result
+    {
+        using value_type = t_value_type;
+
+        std::pair<value_type, value_type> thresholds;
+        /** Confidence interval of the vertical (first) threshold. */
+        std::pair<value_type, value_type> vertical_interval;
+        /** Confidence interval of the horizontal (second) threshold. */
+        std::pair<value_type, value_type> horizontal_interval;
+        estimate<value_type> false_alarm;
+        estimate<value_type> missed_detection;
+        estimate<value_type> null_sample_size;
+        estimate<value_type> alternative_sample_size;
+        /** Indicates that the targets could not be met within the configured threshold ranges. */
+        bool is_saturated;
+
+        /** Largest ratio of standard error to estimated error probability. */
+        value_type relative_error() const noexcept
+        {
+            value_type a = (this->false_alarm.value > 0) ? (this->false_alarm.standard_error / this->false_alarm.value) : 1;
+            value_type b = (this->missed_detection.value > 0) ? (this->missed_detection.standard_error / this->missed_detection.value) : 1;
+            return a > b ? a : b;
+        } // relative_error(...)
+    }; // struct calibration_result
+
+    /** @brief Finds thresholds meeting target error probabilities by stochastic root-finding on recorded paths.
+     *  @details False alarm is estimated by importance sampling from paths simulated under the weakest alternative,
+     *  and missed detection from paths simulated under the null. Every threshold pair is evaluated by reweighting
+     *  the recorded change of measure at the stopping time, so no paths are resimulated while searching.
+     */
+    template <std::floating_point t_value_type, std::size_t t_count_extra_rules>
+    struct calibration_solver
+    {
+        using type = calibration_solver<t_value_type, t_count_extra_rules>;
+        using value_type = t_value_type;
+        using paths_type = calibration_aggregator<value_type, t_count_extra_rules>;
+        using ladder_type = rule_ladder<value_type>;
+        using result_type = calibration_result<value_type>;
+        using range_type = std::pair<value_type, value_type>;
+        using stopping_time_type = ropufu::aftermath::sequential::parallel_stopping_time<value_type, value_type>;
+
+        static constexpr char decide_vertical = stopping_time_type::decide_vertical;
+        static constexpr char decide_horizontal = stopping_time_type::decide_horizontal;
+        /** Two-sided 95% normal quantile. */
+        static constexpr value_type z_score = static_cast<value_type>(1.959963984540054);
+        static constexpr std::size_t count_bisections = 60;
+        static constexpr std::size_t count_alternations = 32;
+
+    private:
+        struct outcome_type
+        {
+            std::size_t time;
+            char which;
+            value_type change_of_measure;
+        }; // struct outcome_type
+
+        const paths_type* m_null_paths;
+        const paths_type* m_alternative_paths;
+
+        static outcome_type decide(const ladder_type& ladder, value_type a, value_type b) noexcept
+        {
+            const ladder_point<value_type>* v = ladder_type::first_crossing(ladder.vertical, a);
+            const ladder_point<value_type>* h = ladder_type::first_crossing(ladder.horizontal, b);
+            if (v == nullptr && h == nullptr)
+            {
+                if (ladder.truncated_at == 0) return {0, 0, 0};
+                // Censored: decided in favor of the hypothesis the statistics favored at truncation.
+                char forced = (ladder.truncated_statistic.first >= ladder.truncated_statistic.second) ? decide_vertical : decide_horizontal;
+                return {ladder.truncated_at, forced, ladder.truncated_change_of_measure};
+            } // if (...)
+            bool is_vertical = (h == nullptr) || (v != nullptr && (v->time < h->time ||
+                (v->time == h->time && v->statistic - a >= h->statistic - b)));
+            const ladder_point<value_type>* p = is_vertical ? v : h;
+            return {p->time, is_vertical ? decide_vertical : decide_horizontal, p->change_of_measure};
+        } // decide(...)
+
+        /** Importance sampling estimate of the probability of \p wrong_decision, and the direct estimate of the sample size. */
+        static std::pair<estimate<value_type>, estimate<value_type>> evaluate(const paths_type& paths,
+            std::size_t rule_index, value_type a, value_type b, char wrong_decision) noexcept
+        {
+            value_type sum_error = 0;
+            value_type sum_error_squared = 0;
+            value_type sum_size = 0;
+            value_type sum_size_squared = 0;
+            for (std::size_t k = 0; k < paths.count(); ++k)
+            {
+                outcome_type outcome = type::decide(paths.ladder(k, rule_index), a, b);
+                value_type error = (outcome.which == wrong_decision) ? std::exp(-outcome.change_of_measure) : 0;
+                value_type size = static_cast<value_type>(outcome.time);
+                sum_error += error;
+                sum_error_squared += error * error;
+                sum_size += size;
+                sum_size_squared += size * size;
+            } // for (...)
+
+            value_type n = static_cast<value_type>(paths.count());
+            auto summarize = [n] (value_type sum, value_type sum_squared) {
+                value_type mean = sum / n;
+                value_type variance = (n > 1) ? (sum_squared - n * mean * mean) / (n - 1) : 0;
+                if (variance < 0) variance = 0;
+                return estimate<value_type>{mean, std::sqrt(variance / n)};
+            };
+            return {summarize(sum_error, sum_error_squared), summarize(sum_size, sum_size_squared)};
+        } // evaluate(...)
+
+        /** @brief Smallest threshold in \p range for which \p error_at, shifted by \p z standard errors, does not exceed \p target.
+         *  @details Error probabilities decrease as the threshold grows.
+         */
+        template <typename t_error_type>
+        static value_type bisect(const range_type& range, value_type target, value_type z, t_error_type&& error_at) noexcept
+        {
+            auto is_above = [&] (value_type x) { return error_at(x).upper(z) > target; };
+            value_type lo = range.first;
+            value_type hi = range.second;
+            if (!is_above(lo)) return lo;
+            if (is_above(hi)) return hi;
+            for (std::size_t k = 0; k < type::count_bisections; ++k)
+            {
+                value_type mid = (lo + hi) / 2;
+                if (is_above(mid)) lo = mid;
+                else hi = mid;
+            } // for (...)
+            return hi;
+        } // bisect(...)
+
+    public:
+        calibration_solver(const paths_type& null_paths, const paths_type& alternative_paths) noexcept
+            : m_null_paths(&null_paths), m_alternative_paths(&alternative_paths)
+        {
+        } // calibration_solver(...)
+
+        /** @param vertical_range Search range of the threshold controlling the missed detection.
+         *  @param horizontal_range Search range of the threshold controlling the false alarm.
+         */
+        result_type solve(std::size_t rule_index, const range_type& vertical_range, const range_type& horizontal_range,
+            value_type false_alarm, value_type missed_detection) const noexcept
+        {
+            const paths_type& null_paths = *this->m_null_paths;
+            const paths_type& alternative_paths = *this->m_alternative_paths;
+
+            auto false_alarm_at = [&] (value_type a, value_type b) {
+                return type::evaluate(alternative_paths, rule_index, a, b, decide_horizontal).first; };
+            auto missed_detection_at = [&] (value_type a, value_type b) {
+                return type::evaluate(null_paths, rule_index, a, b, decide_vertical).first; };
+
+            // Wald's approximation as the starting point.
+            value_type a = std::clamp(-std::log(missed_detection), vertical_range.first, vertical_range.second);
+            value_type b = std::clamp(-std::log(false_alarm), horizontal_range.first, horizontal_range.second);
+            for (std::size_t k = 0; k < type::count_alternations; ++k)
+            {
+                value_type next_b = type::bisect(horizontal_range, false_alarm, 0, [&] (value_type x) { return false_alarm_at(a, x); });
+                value_type next_a = type::bisect(vertical_range, missed_detection, 0, [&] (value_type x) { return missed_detection_at(x, next_b); });
+                bool is_converged = std::abs(next_a - a) <= 1e-6 * (1 + std::abs(a)) && std::abs(next_b - b) <= 1e-6 * (1 + std::abs(b));
+                a = next_a;
+                b = next_b;
+                if (is_converged) break;
+            } // for (...)
+
+            result_type result{};
+            result.thresholds = {a, b};
+            result.vertical_interval = {
+                type::bisect(vertical_range, missed_detection, -type::z_score, [&] (value_type x) { return missed_detection_at(x, b); }),
+                type::bisect(vertical_range, missed_detection, type::z_score, [&] (value_type x) { return missed_detection_at(x, b); })};
+            result.horizontal_interval = {
+                type::bisect(horizontal_range, false_alarm, -type::z_score, [&] (value_type x) { return false_alarm_at(a, x); }),
+                type::bisect(horizontal_range, false_alarm, type::z_score, [&] (value_type x) { return false_alarm_at(a, x); })};
+
+            auto [false_alarm_estimate, alternative_sample_size] = type::evaluate(alternative_paths, rule_index, a, b, decide_horizontal);
+            auto [missed_detection_estimate, null_sample_size] = type::evaluate(null_paths, rule_index, a, b, decide_vertical);
+            result.false_alarm = false_alarm_estimate;
+            result.missed_detection = missed_detection_estimate;
+            result.null_sample_size = null_sample_size;
+            result.alternative_sample_size = alternative_sample_size;
+            result.is_saturated =
+                (a == vertical_range.second && missed_detection_estimate.value > missed_detection) ||
+                (b == horizontal_range.second && false_alarm_estimate.value > false_alarm);
+            return result;
+        } // solve(...)
+    }; // struct calibration_solver
+} // namespace ropufu::sequential::gaussian_mean_hypotheses
+
+namespace ropufu
+{
+    ROPUFU_TMP_TEMPLATE_SIGNATURE
+    struct noexcept_json_serializer<ropufu::sequential::gaussian_mean_hypotheses::ROPUFU_TMP_TYPENAME>
+    {
+        using result_type = ropufu::sequential::gaussian_mean_hypotheses::ROPUFU_TMP_TYPENAME;
+        static bool try_get(const nlohmann::json& j, result_type& x) noexcept
+        {
+            if (!noexcept_json::required(j, result_type::jstr_false_alarm, x.m_false_alarm)) return false;
+            if (!noexcept_json::required(j, result_type::jstr_missed_detection, x.m_missed_detection)) return false;
+            if (!noexcept_json::optional(j, result_type::jstr_relative_tolerance, x.m_relative_tolerance)) return false;
+            if (!noexcept_json::optional(j, result_type::jstr_max_simulations, x.m_max_simulations)) return false;
+            if (!noexcept_json::optional(j, result_type::jstr_max_memory, x.m_max_memory)) return false;
+
+            if (x.empty()) return false;
+            if (x.error_message().has_value()) return false;
+
+            return true;
+        } // try_get(...)
+    }; // struct noexcept_json_serializer<...>
+} // namespace ropufu
+
+#endif // ROPUFU_SEQUENTIAL_GAUSSIAN_MEAN_HYPOTHESES_CALIBRATION_HPP_INCLUDED
@@ -11,11 +11,16 @@
 #include <ropufu/simple_vector.hpp>
 #include <ropufu/vector_extender.hpp>
 
+#include "calibration.hpp"
 #include "model.hpp"
+#include "noise_pipeline.hpp"
+#include "noise_trace.hpp"
+#include "results_store.hpp"
 
 #include <concepts>    // std::floating_point
 #include <cstddef>     // std::size_t
 #include <functional>  // std::hash
+#include <map>         // std::map
 #include <optional>    // std::optional, std::nullopt
 #include <stdexcept>   // std::logic_error, std::runtime_error
 #include <string>      // std::string
@@ -57,19 +62,48 @@ namespace ropufu::sequential::gaussian_mean_hypotheses
         static constexpr std::string_view jstr_count_simulations = "simulations";
         static constexpr std::string_view jstr_model = "model";
         static constexpr std::string_view jstr_anticipated_sample_size = "anticipated sample size";
+        static constexpr std::string_view jstr_max_sample_size = "max sample size";
         static constexpr std::string_view jstr_asprt_thresholds = "ASPRT thresholds";
         static constexpr std::string_view jstr_gsprt_thresholds = "GSPRT thresholds";
+        static constexpr std::string_view jstr_rule_thresholds = "rule thresholds";
+        static constexpr std::string_view jstr_noise_trace = "noise trace";
+        static constexpr std::string_view jstr_calibration = "calibration";
+        static constexpr std::string_view jstr_pin_threads = "pin threads";
+        static constexpr std::string_view jstr_noise_pipeline = "noise pipeline";
+        static constexpr std::string_view jstr_results_store = "results store";
 
         friend ropufu::noexcept_json_serializer<type>;
 
         std::size_t count_simulations;
         model_type model;
         std::pair<value_type, value_type> anticipated_sample_size;
+        /** Paths are truncated after this many observations, with forced decisions; zero if paths are never truncated. */
+        std::size_t max_sample_size = 0;
         thresholds_type asprt_thresholds;
         thresholds_type gsprt_thresholds;
+        /** Thresholds of additional stopping rules, keyed by rule name; every registered rule has to be listed. */
+        std::map<std::string, thresholds_type> rule_thresholds;
+        noise_trace_settings trace;
+        /** If set, thresholds are calibrated to target error probabilities instead of simulated on the grids. */
+        calibration_settings<value_type> calibration;
+        /** If set, worker threads are pinned to cores and build their own state, so that it stays on their NUMA node. */
+        bool pin_threads = false;
+        /** If set, noise is generated on dedicated producer threads and handed to the simulators. */
+        noise_pipeline_settings pipeline;
+        /** If set, results are kept between runs, and later runs with the same setup only simulate the paths still missing. */
+        results_store_settings store;
 
         config() noexcept = default;
 
+        /** @brief Thresholds for the additional rule \p rule_name; null if the rule is not listed.
+         *  @details There is no fallback: the statistics of other rules grow at different rates, and borrowed thresholds may never be crossed.
+         */
+        const thresholds_type* thresholds_for(std::string_view rule_name) const noexcept
+        {
+            auto search = this->rule_thresholds.find(std::string(rule_name));
+            return (search == this->rule_thresholds.end()) ? nullptr : &(search->second);
+        } // thresholds_for(...)
+
         friend void to_json(nlohmann::json& j, const type& x) noexcept
         {
             j = nlohmann::json{
@@ -79,6 +113,13 @@ namespace ropufu::sequential::gaussian_mean_hypotheses
                 {type::jstr_asprt_thresholds, x.asprt_thresholds},
                 {type::jstr_gsprt_thresholds, x.gsprt_thresholds}
             };
+            if (x.max_sample_size != 0) j[std::string(type::jstr_max_sample_size)] = x.max_sample_size;
+            if (!x.rule_thresholds.empty()) j[std::string(type::jstr_rule_thresholds)] = x.rule_thresholds;
+            if (!x.trace.empty()) j[std::string(type::jstr_noise_trace)] = x.trace;
+            if (!x.calibration.empty()) j[std::string(type::jstr_calibration)] = x.calibration;
+            if (x.pin_threads) j[std::string(type::jstr_pin_threads)] = x.pin_threads;
+            if (!x.pipeline.empty()) j[std::string(type::jstr_noise_pipeline)] = x.pipeline;
+            if (!x.store.empty()) j[std::string(type::jstr_results_store)] = x.store;
         } // to_json(...)
 
         friend void from_json(const nlohmann::json& j, type& x)
@@ -122,11 +163,30 @@ namespace ropufu
             if (!noexcept_json::required(j, result_type::jstr_count_simulations, x.count_simulations)) return false;
             if (!noexcept_json::required(j, result_type::jstr_model, x.model)) return false;
             if (!noexcept_json::required(j, result_type::jstr_anticipated_sample_size, x.anticipated_sample_size)) return false;
+            if (!noexcept_json::optional(j, result_type::jstr_max_sample_size, x.max_sample_size)) return false;
             if (!noexcept_json::required(j, result_type::jstr_asprt_thresholds, asprt_thresholds)) return false;
             if (!noexcept_json::required(j, result_type::jstr_gsprt_thresholds, gsprt_thresholds)) return false;
+            if (!noexcept_json::optional(j, result_type::jstr_noise_trace, x.trace)) return false;
+            if (!noexcept_json::optional(j, result_type::jstr_calibration, x.calibration)) return false;
+            if (!noexcept_json::optional(j, result_type::jstr_pin_threads, x.pin_threads)) return false;
+            if (!noexcept_json::optional(j, result_type::jstr_noise_pipeline, x.pipeline)) return false;
+            if (!noexcept_json::optional(j, result_type::jstr_results_store, x.store)) return false;
             
             initialize(asprt_thresholds, x.asprt_thresholds);
             initialize(gsprt_thresholds, x.gsprt_thresholds);
+
+            x.rule_thresholds.clear();
+            auto rule_thresholds_search = j.find(std::string(result_type::jstr_rule_thresholds));
+            if (rule_thresholds_search != j.end())
+            {
+                if (!rule_thresholds_search->is_object()) return false;
+                for (const auto& item : rule_thresholds_search->items())
+                {
+                    std::pair<initializer_type, initializer_type> rule_thresholds;
+                    if (!noexcept_json::try_get(item.value(), rule_thresholds)) return false;
+                    initialize(rule_thresholds, x.rule_thresholds[item.key()]);
+                } // for (...)
+            } // if (...)
             
             return true;
         } // try_get(...)
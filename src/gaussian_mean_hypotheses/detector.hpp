@@ -0,0 +1,123 @@
+
+#ifndef ROPUFU_SEQUENTIAL_GAUSSIAN_MEAN_HYPOTHESES_DETECTOR_HPP_INCLUDED
+#define ROPUFU_SEQUENTIAL_GAUSSIAN_MEAN_HYPOTHESES_DETECTOR_HPP_INCLUDED
+
+#include <ropufu/algebra/matrix.hpp>
+
+#include "model.hpp"
+#include "xsprt.hpp"
+
+#include <array>       // std::array
+#include <concepts>    // std::floating_point
+#include <cstddef>     // std::size_t
+#include <string_view> // std::string_view
+
+namespace ropufu::sequential::gaussian_mean_hypotheses
+{
+    /** Decision made by a single threshold pair of an online detector. */
+    struct detector_decision
+    {
+        /** Number of completed segments prior to this decision. */
+        std::size_t segment;
+        /** Number of observations within the current segment. */
+        std::size_t time;
+        /** Index of the rule in \c detector::rule_names. */
+        std::size_t rule;
+        std::size_t row;
+        std::size_t column;
+        char which;
+    }; // struct detector_decision
+
+    /** @brief Runs ASPRT and GSPRT on a live stream of observations.
+     *  @details Every threshold pair reports its decision as soon as it stops. Once all pairs
+     *  have stopped, the statistic is reset and a new segment starts with the next observation.
+     *  Storage is allocated at construction; \c observe does not allocate.
+     */
+    template <std::floating_point t_value_type>
+    struct detector
+    {
+        using type = detector<t_value_type>;
+        using value_type = t_value_type;
+
+        using statistic_type = xsprt<value_type>;
+        using model_type = typename statistic_type::model_type;
+        using stopping_time_type = typename statistic_type::stopping_time_type;
+        using thresholds_type = typename statistic_type::thresholds_type;
+
+        template <typename t_data_type>
+        using matrix_t = ropufu::aftermath::algebra::matrix<t_data_type>;
+
+        static constexpr std::size_t count_rules = 2;
+        static constexpr std::array<std::string_view, count_rules> rule_names = {"ASPRT", "GSPRT"};
+
+    private:
+        statistic_type m_statistic = {};
+        std::array<matrix_t<char>, count_rules> m_is_reported = {};
+        std::array<std::size_t, count_rules> m_count_reported = {};
+        std::size_t m_segment = 0;
+
+        const stopping_time_type& rule(std::size_t index) const noexcept
+        {
+            return index == 0 ? this->m_statistic.adaptive_sprt() : this->m_statistic.generalized_sprt();
+        } // rule(...)
+
+        template <typename t_sink_type>
+        void report(std::size_t index, t_sink_type& sink) noexcept
+        {
+            matrix_t<char>& is_reported = this->m_is_reported[index];
+            if (this->m_count_reported[index] == is_reported.size()) return; // Every pair has already stopped.
+
+            const matrix_t<char>& which = this->rule(index).which();
+            for (std::size_t i = 0; i < is_reported.height(); ++i)
+            {
+                for (std::size_t j = 0; j < is_reported.width(); ++j)
+                {
+                    if (which(i, j) == 0 || is_reported(i, j) != 0) continue;
+                    is_reported(i, j) = 1;
+                    ++this->m_count_reported[index];
+                    sink(detector_decision{this->m_segment, this->m_statistic.count_observations(), index, i, j, which(i, j)});
+                } // for (...)
+            } // for (...)
+        } // report(...)
+
+    public:
+        detector() noexcept = default;
+
+        detector(const model_type& model, const thresholds_type& asprt_thresholds, const thresholds_type& gsprt_thresholds) noexcept
+            : m_statistic(model, asprt_thresholds, gsprt_thresholds, 0, 0, 0)
+        {
+            for (std::size_t index = 0; index < count_rules; ++index)
+            {
+                const matrix_t<char>& which = this->rule(index).which();
+                this->m_is_reported[index] = matrix_t<char>(which.height(), which.width());
+            } // for (...)
+        } // detector(...)
+
+        const statistic_type& statistic() const noexcept { return this->m_statistic; }
+
+        std::size_t count_segments() const noexcept { return this->m_segment; }
+
+        void reset() noexcept
+        {
+            this->m_statistic.reset();
+            for (matrix_t<char>& x : this->m_is_reported) for (char& flag : x) flag = 0;
+            this->m_count_reported = {};
+        } // reset(...)
+
+        /** @brief Feeds one observation, passing every new decision to \p sink. */
+        template <typename t_sink_type>
+        void observe(value_type value, t_sink_type&& sink) noexcept
+        {
+            this->m_statistic.observe(value);
+            for (std::size_t index = 0; index < count_rules; ++index) this->report(index, sink);
+
+            if (!this->m_statistic.is_running())
+            {
+                this->reset();
+                ++this->m_segment;
+            } // if (...)
+        } // observe(...)
+    }; // struct detector
+} // namespace ropufu::sequential::gaussian_mean_hypotheses
+
+#endif // ROPUFU_SEQUENTIAL_GAUSSIAN_MEAN_HYPOTHESES_DETECTOR_HPP_INCLUDED
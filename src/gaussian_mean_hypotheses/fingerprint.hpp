@@ -0,0 +1,65 @@
+
+#ifndef ROPUFU_SEQUENTIAL_GAUSSIAN_MEAN_HYPOTHESES_FINGERPRINT_HPP_INCLUDED
+#define ROPUFU_SEQUENTIAL_GAUSSIAN_MEAN_HYPOTHESES_FINGERPRINT_HPP_INCLUDED
+
+#include <cstddef>     // std::size_t
+#include <cstdint>     // std::uint64_t
+#include <string>      // std::string
+#include <string_view> // std::string_view
+#include <type_traits> // std::is_trivially_copyable_v
+
+namespace ropufu::sequential::gaussian_mean_hypotheses
+{
+    /** @brief 64-bit FNV-1a hash.
+     *  @details Unlike \c std::hash, it is the same in every build, so it may name things that outlive the program.
+     */
+    struct fingerprint
+    {
+        using type = fingerprint;
+
+        static constexpr std::uint64_t offset_basis = 14'695'981'039'346'656'037ULL;
+        static constexpr std::uint64_t prime = 1'099'511'628'211ULL;
+
+    private:
+        std::uint64_t m_value = type::offset_basis;
+
+    public:
+        constexpr fingerprint() noexcept = default;
+
+        constexpr std::uint64_t value() const noexcept { return this->m_value; }
+
+        constexpr void add(std::string_view text) noexcept
+        {
+            for (char c : text)
+            {
+                this->m_value ^= static_cast<unsigned char>(c);
+                this->m_value *= type::prime;
+            } // for (...)
+        } // add(...)
+
+        /** Adds the in-memory representation of \p x. */
+        template <typename t_data_type>
+            requires std::is_trivially_copyable_v<t_data_type>
+        void add_bytes(const t_data_type& x) noexcept
+        {
+            const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&x);
+            for (std::size_t k = 0; k < sizeof(t_data_type); ++k)
+            {
+                this->m_value ^= bytes[k];
+                this->m_value *= type::prime;
+            } // for (...)
+        } // add_bytes(...)
+
+        /** Sixteen lowercase hexadecimal digits. */
+        std::string to_string() const noexcept
+        {
+            constexpr char digits[] = "0123456789abcdef";
+            std::uint64_t x = this->m_value;
+            std::string result(16, '0');
+            for (std::size_t k = 16; k != 0; --k, x >>= 4) result[k - 1] = digits[x & 0xF];
+            return result;
+        } // to_string(...)
+    }; // struct fingerprint
+} // namespace ropufu::sequential::gaussian_mean_hypotheses
+
+#endif // ROPUFU_SEQUENTIAL_GAUSSIAN_MEAN_HYPOTHESES_FINGERPRINT_HPP_INCLUDED
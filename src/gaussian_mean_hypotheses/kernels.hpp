@@ -0,0 +1,225 @@
+
+#ifndef ROPUFU_SEQUENTIAL_GAUSSIAN_MEAN_HYPOTHESES_KERNELS_HPP_INCLUDED
+#define ROPUFU_SEQUENTIAL_GAUSSIAN_MEAN_HYPOTHESES_KERNELS_HPP_INCLUDED
+
+#include <array>       // std::array
+#include <concepts>    // std::floating_point
+#include <cstddef>     // std::size_t
+#include <string_view> // std::string_view
+
+// Per-function target attributes and CPU detection are only available in GCC and Clang on x86.
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define ROPUFU_GAUSSIAN_MEAN_HYPOTHESES_KERNEL_DISPATCH
+#define ROPUFU_GAUSSIAN_MEAN_HYPOTHESES_KERNEL_BODY [[gnu::always_inline]] inline
+#define ROPUFU_GAUSSIAN_MEAN_HYPOTHESES_FLATTEN [[gnu::flatten]]
+#else
+#define ROPUFU_GAUSSIAN_MEAN_HYPOTHESES_KERNEL_BODY inline
+#define ROPUFU_GAUSSIAN_MEAN_HYPOTHESES_FLATTEN
+#endif
+
+namespace ropufu::sequential::gaussian_mean_hypotheses::kernels
+{
+    /** Number of values of type \p t_value_type filling a cache line. */
+    template <std::floating_point t_value_type>
+    inline constexpr std::size_t lanes = 64 / sizeof(t_value_type);
+
+    /** @brief Instruction sets the kernels are built for.
+     *  @details Besides the channel reductions, every simulated path and its aggregation is built for each of them, see \c run.
+     */
+    enum struct instruction_set : char
+    {
+        scalar = 0,
+        avx2 = 1,
+        avx512 = 2
+    }; // enum struct instruction_set
+
+    inline constexpr std::array<std::string_view, 3> instruction_set_names = {"scalar", "avx2", "avx512"};
+
+    inline std::string_view to_string(instruction_set x) noexcept { return instruction_set_names[static_cast<std::size_t>(x)]; }
+
+    /** @return False if \p name does not name an instruction set. */
+    inline bool try_parse(std::string_view name, instruction_set& x) noexcept
+    {
+        for (std::size_t k = 0; k < instruction_set_names.size(); ++k)
+        {
+            if (name != instruction_set_names[k]) continue;
+            x = static_cast<instruction_set>(k);
+            return true;
+        } // for (...)
+        return false;
+    } // try_parse(...)
+
+    /** Checks if the current CPU supports \p x. */
+    inline bool is_supported(instruction_set x) noexcept
+    {
+#ifdef ROPUFU_GAUSSIAN_MEAN_HYPOTHESES_KERNEL_DISPATCH
+        __builtin_cpu_init();
+        switch (x)
+        {
+        case instruction_set::scalar: return true;
+        case instruction_set::avx2: return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+        case instruction_set::avx512: return __builtin_cpu_supports("avx512f");
+        } // switch (...)
+        return false;
+#else
+        return x == instruction_set::scalar;
+#endif
+    } // is_supported(...)
+
+    /** Widest instruction set supported by the current CPU. */
+    inline instruction_set detect() noexcept
+    {
+        if (is_supported(instruction_set::avx512)) return instruction_set::avx512;
+        if (is_supported(instruction_set::avx2)) return instruction_set::avx2;
+        return instruction_set::scalar;
+    } // detect(...)
+
+    namespace detail
+    {
+        /** @brief Sum of products x[k] y[k] for k < n.
+         *  @details Keeps one partial sum per lane, so that the compiler may vectorize the loop without reassociating it.
+         *  Always inlined, so that each variant below is compiled for its own instruction set.
+         */
+        template <std::floating_point t_value_type>
+        ROPUFU_GAUSSIAN_MEAN_HYPOTHESES_KERNEL_BODY t_value_type dot_body(const t_value_type* x, const t_value_type* y, std::size_t n) noexcept
+        {
+            constexpr std::size_t width = lanes<t_value_type>;
+            t_value_type partial[width] = {};
+
+            std::size_t k = 0;
+            for (; k + width <= n; k += width)
+                for (std::size_t j = 0; j < width; ++j) partial[j] += x[k + j] * y[k + j];
+
+            t_value_type result = 0;
+            for (; k < n; ++k) result += x[k] * y[k];
+            for (std::size_t j = 0; j < width; ++j) result += partial[j];
+            return result;
+        } // dot_body(...)
+
+        /** Adds a x[k] to y[k] for k < n. */
+        template <std::floating_point t_value_type>
+        ROPUFU_GAUSSIAN_MEAN_HYPOTHESES_KERNEL_BODY void axpy_body(t_value_type a, const t_value_type* x, t_value_type* y, std::size_t n) noexcept
+        {
+            for (std::size_t k = 0; k < n; ++k) y[k] += a * x[k];
+        } // axpy_body(...)
+
+        template <std::floating_point t_value_type>
+        t_value_type dot_scalar(const t_value_type* x, const t_value_type* y, std::size_t n) noexcept { return dot_body(x, y, n); }
+
+        template <std::floating_point t_value_type>
+        void axpy_scalar(t_value_type a, const t_value_type* x, t_value_type* y, std::size_t n) noexcept { axpy_body(a, x, y, n); }
+
+#ifdef ROPUFU_GAUSSIAN_MEAN_HYPOTHESES_KERNEL_DISPATCH
+        template <std::floating_point t_value_type>
+        [[gnu::target("avx2,fma")]] t_value_type dot_avx2(const t_value_type* x, const t_value_type* y, std::size_t n) noexcept { return dot_body(x, y, n); }
+
+        template <std::floating_point t_value_type>
+        [[gnu::target("avx2,fma")]] void axpy_avx2(t_value_type a, const t_value_type* x, t_value_type* y, std::size_t n) noexcept { axpy_body(a, x, y, n); }
+
+        template <std::floating_point t_value_type>
+        [[gnu::target("avx512f")]] t_value_type dot_avx512(const t_value_type* x, const t_value_type* y, std::size_t n) noexcept { return dot_body(x, y, n); }
+
+        template <std::floating_point t_value_type>
+        [[gnu::target("avx512f")]] void axpy_avx512(t_value_type a, const t_value_type* x, t_value_type* y, std::size_t n) noexcept { axpy_body(a, x, y, n); }
+#endif
+
+        template <typename t_body_type>
+        ROPUFU_GAUSSIAN_MEAN_HYPOTHESES_FLATTEN decltype(auto) run_scalar(t_body_type& body) noexcept(noexcept(body())) { return body(); }
+
+#ifdef ROPUFU_GAUSSIAN_MEAN_HYPOTHESES_KERNEL_DISPATCH
+        template <typename t_body_type>
+        [[gnu::target("avx2,fma"), gnu::flatten]] decltype(auto) run_avx2(t_body_type& body) noexcept(noexcept(body())) { return body(); }
+
+        template <typename t_body_type>
+        [[gnu::target("avx512f"), gnu::flatten]] decltype(auto) run_avx512(t_body_type& body) noexcept(noexcept(body())) { return body(); }
+#endif
+    } // namespace detail
+
+    /** Kernels built for one instruction set. */
+    template <std::floating_point t_value_type>
+    struct kernel_table
+    {
+        using value_type = t_value_type;
+
+        instruction_set target = instruction_set::scalar;
+        value_type (*dot)(const value_type*, const value_type*, std::size_t) noexcept = &detail::dot_scalar<value_type>;
+        void (*axpy)(value_type, const value_type*, value_type*, std::size_t) noexcept = &detail::axpy_scalar<value_type>;
+
+        kernel_table() noexcept = default;
+
+        explicit kernel_table(instruction_set x) noexcept
+        {
+            switch (x)
+            {
+#ifdef ROPUFU_GAUSSIAN_MEAN_HYPOTHESES_KERNEL_DISPATCH
+            case instruction_set::avx2:
+                this->target = x;
+                this->dot = &detail::dot_avx2<value_type>;
+                this->axpy = &detail::axpy_avx2<value_type>;
+                break;
+            case instruction_set::avx512:
+                this->target = x;
+                this->dot = &detail::dot_avx512<value_type>;
+                this->axpy = &detail::axpy_avx512<value_type>;
+                break;
+#endif
+            default:
+                break;
+            } // switch (...)
+        } // kernel_table(...)
+    }; // struct kernel_table
+
+    /** Kernels in use, chosen from the CPU features at startup. */
+    template <std::floating_point t_value_type>
+    inline kernel_table<t_value_type> active = kernel_table<t_value_type>(detect());
+
+    /** @brief Switches every kernel to \p x; intended to be called before any simulation starts.
+     *  @return False if the current CPU, or the compiler, does not support \p x.
+     */
+    inline bool select(instruction_set x) noexcept
+    {
+        if (!is_supported(x)) return false;
+        active<float> = kernel_table<float>(x);
+        active<double> = kernel_table<double>(x);
+        active<long double> = kernel_table<long double>(x);
+        return true;
+    } // select(...)
+
+    /** Instruction set the kernels of type \p t_value_type were built for. */
+    template <std::floating_point t_value_type>
+    instruction_set selected() noexcept { return active<t_value_type>.target; }
+
+    /** Sum of products x[k] y[k] for k < n. */
+    template <std::floating_point t_value_type>
+    t_value_type dot(const t_value_type* x, const t_value_type* y, std::size_t n) noexcept
+    {
+        return active<t_value_type>.dot(x, y, n);
+    } // dot(...)
+
+    /** Adds a x[k] to y[k] for k < n. */
+    template <std::floating_point t_value_type>
+    void axpy(t_value_type a, const t_value_type* x, t_value_type* y, std::size_t n) noexcept
+    {
+        active<t_value_type>.axpy(a, x, y, n);
+    } // axpy(...)
+
+    /** @brief Calls \p body built for the selected instruction set.
+     *  @details Everything \p body calls is inlined into one copy per instruction set (gnu::flatten), so whole
+     *  paths run on the selected instructions, not just the kernels. Calls through pointers, such as the kernels
+     *  themselves, stay calls.
+     */
+    template <std::floating_point t_value_type, typename t_body_type>
+    decltype(auto) run(t_body_type&& body) noexcept(noexcept(body()))
+    {
+        switch (active<t_value_type>.target)
+        {
+#ifdef ROPUFU_GAUSSIAN_MEAN_HYPOTHESES_KERNEL_DISPATCH
+        case instruction_set::avx2: return detail::run_avx2(body);
+        case instruction_set::avx512: return detail::run_avx512(body);
+#endif
+        default: return detail::run_scalar(body);
+        } // switch (...)
+    } // run(...)
+} // namespace ropufu::sequential::gaussian_mean_hypotheses::kernels
+
+#endif // ROPUFU_SEQUENTIAL_GAUSSIAN_MEAN_HYPOTHESES_KERNELS_HPP_INCLUDED
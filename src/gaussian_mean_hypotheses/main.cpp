@@ -7,27 +7,50 @@
 #include <ropufu/random/monte_carlo.hpp>
 
 #include "aggregator.hpp"
+#include "calibration.hpp"
 #include "config.hpp"
+#include "kernels.hpp"
 #include "model.hpp"
+#include "noise_pipeline.hpp"
+#include "noise_trace.hpp"
+#include "pinned_monte_carlo.hpp"
+#include "results_store.hpp"
+#include "rules.hpp"
 #include "simulator.hpp"
+#include "stopping_time_histogram.hpp"
+#include "thread_affinity.hpp"
 #include "xsprt.hpp"
 
 #include <array>        // std::array
 #include <chrono>       // std::chrono::steady_clock, std::chrono::duration_cast
-#include <cmath>        // std::sqrt, std::log10
+#include <cmath>        // std::abs, std::sqrt, std::log10
 #include <cstddef>      // std::size_t
 #include <filesystem>   // std::filesystem::path
 #include <fstream>      // std::ifstream
 #include <iomanip>      // std::setw
 #include <ios>          // std::ios_base::failure
 #include <iostream>     // std::cout, std::endl
-#include <random>       // std::mt19937_64
+#include <limits>       // std::numeric_limits
+#include <memory>       // std::unique_ptr, std::make_unique
+#include <random>       // std::mt19937_64, std::seed_seq
+#include <stdexcept>    // std::runtime_error
+#include <string>       // std::string
+#include <string_view>  // std::string_view
+#include <typeinfo>     // typeid
+#include <utility>      // std::pair
+#include <vector>       // std::vector
 
 enum struct execution_result : int
 {
     all_good = 0,
     failed_to_read_config_file = 1,
-    failed_to_parse_config_file = 7
+    failed_to_open_noise_trace = 2,
+    invalid_arguments = 3,
+    failed_to_parse_config_file = 7,
+    missing_rule_thresholds = 8,
+    signal_too_short = 9,
+    truncation_check_failed = 10,
+    calibration_memory_exceeded = 11
 }; // struct execution_result
 
 void separator()
@@ -35,10 +58,9 @@ void separator()
     std::cout << "======================================================================" << std::endl;
 } // separator(...)
 
-template <typename t_moment_statistic_type, typename t_transform_type>
-void cat(const t_moment_statistic_type& stat, t_transform_type&& transform) noexcept
+template <typename t_matrix_type, typename t_transform_type>
+void cat_corners(const t_matrix_type& mat, t_transform_type&& transform) noexcept
 {
-    const auto& mat = stat.mean();
     std::size_t m = mat.height();
     std::size_t n = mat.width();
     if (m == 0 || n == 0) return;
@@ -55,6 +77,14 @@ void cat(const t_moment_statistic_type& stat, t_transform_type&& transform) noex
         std::setw(10) << transform(mat(m - 1, 0)) <<
         std::setw(10) << " --- " <<
         std::setw(10) << transform(mat(m - 1, n - 1)) << std::endl;
+} // cat_corners(...)
+
+template <typename t_moment_statistic_type, typename t_transform_type>
+void cat(const t_moment_statistic_type& stat, t_transform_type&& transform) noexcept
+{
+    const auto& mat = stat.mean();
+    if (mat.height() == 0 || mat.width() == 0) return;
+    ::cat_corners(mat, transform);
 
     const auto& var = stat.variance();
     auto max_var = *(var.cbegin());
@@ -69,22 +99,56 @@ void cat(const t_moment_statistic_type& stat) noexcept
     ::cat(stat, [] (auto x) { return x; });
 } // cat(...)
 
-template <typename t_value_type, typename t_engine_type, std::size_t t_count_threads>
+/** Prints tail quantiles of the stopping times in the corner cells. */
+template <typename t_value_type>
+void cat_quantiles(const ropufu::sequential::gaussian_mean_hypotheses::stopping_time_histogram<t_value_type>& histogram) noexcept
+{
+    for (t_value_type p : {0.5, 0.95, 0.99})
+    {
+        std::cout << "p" << (100 * p) << ":" << std::endl;
+        ::cat_corners(histogram.quantile(p), [] (auto x) { return x; });
+    } // for (...)
+} // cat_quantiles(...)
+
+/** Prints tail quantiles of the number of observations per path. */
+template <typename t_value_type>
+void cat_path_lengths(const ropufu::sequential::gaussian_mean_hypotheses::stopping_time_histogram<t_value_type>& histogram,
+    std::size_t longest_path, std::size_t count_truncated_paths) noexcept
+{
+    std::cout << "Path length:";
+    for (t_value_type p : {0.5, 0.99, 0.999}) std::cout << " p" << (100 * p) << " = " << histogram.quantile(p)(0, 0) << ",";
+    std::cout << " longest = " << longest_path << std::endl;
+    std::cout << "Truncated paths: " << count_truncated_paths << std::endl;
+} // cat_path_lengths(...)
+
+template <typename t_value_type, typename t_engine_type, std::size_t t_count_threads, typename... t_extra_rule_types>
 struct program
 {
-    using type = program<t_value_type, t_engine_type, t_count_threads>;
+    using type = program<t_value_type, t_engine_type, t_count_threads, t_extra_rule_types...>;
     using value_type = t_value_type;
     using engine_type = t_engine_type;
     static constexpr std::size_t count_threads = t_count_threads;
 
-    using simulator_type = ropufu::sequential::gaussian_mean_hypotheses::simulator<value_type, engine_type>;
-    using aggregator_type = ropufu::sequential::gaussian_mean_hypotheses::aggregator<value_type>;
+    using simulator_type = ropufu::sequential::gaussian_mean_hypotheses::simulator<value_type, engine_type, t_extra_rule_types...>;
+    using aggregator_type = ropufu::sequential::gaussian_mean_hypotheses::aggregator<value_type, t_extra_rule_types...>;
 
     using config_type = ropufu::sequential::gaussian_mean_hypotheses::config<value_type>;
     using statistic_type = typename simulator_type::statistic_type;
     using model_type = typename statistic_type::model_type;
+    using noise_trace_type = typename simulator_type::noise_trace_type;
+    using noise_pipeline_type = typename simulator_type::noise_pipeline_type;
+    using noise_usage_type = ropufu::sequential::gaussian_mean_hypotheses::noise_usage;
+    using thresholds_type = typename statistic_type::thresholds_type;
+    using extra_thresholds_type = std::array<thresholds_type, statistic_type::count_extra_rules>;
 
     using monte_carlo_type = ropufu::aftermath::random::monte_carlo<simulator_type, aggregator_type, count_threads>;
+    using pinned_monte_carlo_type = ropufu::sequential::gaussian_mean_hypotheses::pinned_monte_carlo<simulator_type, aggregator_type>;
+
+    using calibration_simulator_type = ropufu::sequential::gaussian_mean_hypotheses::calibration_simulator<value_type, engine_type, t_extra_rule_types...>;
+    using calibration_aggregator_type = ropufu::sequential::gaussian_mean_hypotheses::calibration_aggregator<value_type, statistic_type::count_extra_rules>;
+    using calibration_solver_type = ropufu::sequential::gaussian_mean_hypotheses::calibration_solver<value_type, statistic_type::count_extra_rules>;
+    using calibration_monte_carlo_type = ropufu::aftermath::random::monte_carlo<calibration_simulator_type, calibration_aggregator_type, count_threads>;
+    using range_type = std::pair<value_type, value_type>;
 
     static bool try_read_json(const std::filesystem::path& path, nlohmann::json& j) noexcept
     {
@@ -101,36 +165,533 @@ struct program
         } // catch(...)
     } // try_read_json(...)
 
-    static void run(std::size_t count_simulations, const statistic_type& xsprt) noexcept
+    static ::execution_result try_read_config(const std::filesystem::path& config_path, config_type& config) noexcept
     {
-        std::chrono::steady_clock::time_point start{};
-        std::chrono::steady_clock::time_point end{};
-        
-        std::array<simulator_type, count_threads> simulators{};
-        for (std::size_t i = 0; i < count_threads; ++i)
-            simulators[i] = simulator_type(xsprt);
+        nlohmann::json j{};
+        if (!type::try_read_json(config_path, j))
+        {
+            std::cout << "Failed to read config file." << std::endl;
+            return ::execution_result::failed_to_read_config_file;
+        } // if (...)
+
+        if (!ropufu::noexcept_json::try_get(j, config))
+        {
+            std::cout << "Failed to parse config file." << std::endl;
+            return ::execution_result::failed_to_parse_config_file;
+        } // if (...)
+
+        // Chirp and file signals are only known up to their length; longer paths would silently repeat them.
+        std::size_t horizon = config.model.horizon();
+        if (horizon != 0 && (config.max_sample_size == 0 || config.max_sample_size > horizon))
+        {
+            std::cout << "Signal is only known for " << horizon << " observations: max sample size must not exceed it." << std::endl;
+            return ::execution_result::signal_too_short;
+        } // if (...)
+
+        return ::execution_result::all_good;
+    } // try_read_config(...)
+
+    /** Looks up the thresholds of every additional rule in \p config. */
+    static ::execution_result try_get_extra_thresholds(const config_type& config, extra_thresholds_type& extra_thresholds) noexcept
+    {
+        for (std::size_t k = 0; k < statistic_type::count_extra_rules; ++k)
+        {
+            const thresholds_type* thresholds = config.thresholds_for(statistic_type::extra_rule_names[k]);
+            if (thresholds == nullptr)
+            {
+                std::cout << "Missing thresholds for rule " << statistic_type::extra_rule_names[k] << "." << std::endl;
+                return ::execution_result::missing_rule_thresholds;
+            } // if (...)
+            extra_thresholds[k] = *thresholds;
+        } // for (...)
+        return ::execution_result::all_good;
+    } // try_get_extra_thresholds(...)
 
+    /** Seeds of \p count independent threads. */
+    static std::vector<std::array<int, 2>> make_seeds(std::size_t count) noexcept
+    {
         int time_seed = static_cast<int>(std::chrono::system_clock::now().time_since_epoch().count());
         std::seed_seq main_sequence{ 1, 1, 2, 3, 5, 8, 1729, time_seed };
         engine_type seed_engine{main_sequence};
+        std::vector<std::array<int, 2>> result(count);
+        for (std::array<int, 2>& x : result) x = {static_cast<int>(seed_engine()), static_cast<int>(seed_engine())};
+        return result;
+    } // make_seeds(...)
+
+    template <typename t_simulator_type>
+    static void seed(t_simulator_type& simulator, const std::array<int, 2>& seed) noexcept
+    {
+        std::seed_seq threaded_sequence{1, 7, 2, 9, seed[0], seed[1]};
+        simulator.seed(threaded_sequence);
+    } // seed(...)
+
+    template <typename t_simulator_type>
+    static void seed(std::array<t_simulator_type, count_threads>& simulators) noexcept
+    {
+        std::vector<std::array<int, 2>> seeds = type::make_seeds(count_threads);
+        for (std::size_t i = 0; i < count_threads; ++i) type::seed(simulators[i], seeds[i]);
+    } // seed(...)
+
+    /** @brief Runs \p count_simulations simulations on workers that are pinned to cores and own their state.
+     *  @param pipeline If not null, worker i takes its noise from consumer i of \p pipeline.
+     *  @param usage If not null, workers report the noise they generated and observed to \p usage.
+     */
+    static aggregator_type simulate_pinned(pinned_monte_carlo_type& mc, std::size_t count_simulations, const statistic_type& xsprt,
+        noise_trace_type* trace, bool is_recording, noise_pipeline_type* pipeline, noise_usage_type* usage) noexcept
+    {
+        std::vector<std::array<int, 2>> seeds = type::make_seeds(mc.count_threads());
+        return mc.execute_sync(count_simulations, [&] (std::size_t i) {
+            simulator_type simulator{xsprt};
+            type::seed(simulator, seeds[i]);
+            if (pipeline != nullptr) simulator.attach_feed(pipeline->consumer(i));
+            if (usage != nullptr) simulator.count_usage_in(*usage);
+            if (trace != nullptr)
+            {
+                if (is_recording) simulator.record_to(*trace);
+                else simulator.replay_from(*trace);
+            } // if (...)
+            return simulator;
+        });
+    } // simulate_pinned(...)
+
+    /** Measures throughput of pinned workers, from one thread to all available processors, with a fixed number of paths per thread. */
+    static ::execution_result benchmark_scaling(const std::filesystem::path& config_path) noexcept
+    {
+        config_type config{};
+        ::execution_result result = type::try_read_config(config_path, config);
+        if (result != ::execution_result::all_good) return result;
+
+        extra_thresholds_type extra_thresholds{};
+        result = type::try_get_extra_thresholds(config, extra_thresholds);
+        if (result != ::execution_result::all_good) return result;
+        statistic_type xsprt_null{config.model, config.asprt_thresholds, config.gsprt_thresholds,
+            0, config.model.weakest_signal_strength(), config.anticipated_sample_size.first, extra_thresholds};
+        xsprt_null.truncate_at(config.max_sample_size);
+
+        std::size_t max_threads = ropufu::sequential::gaussian_mean_hypotheses::count_available_processors();
+        std::vector<std::size_t> counts_threads{};
+        for (std::size_t t = 1; t < max_threads; t *= 2) counts_threads.push_back(t);
+        counts_threads.push_back(max_threads);
+
+        ::separator();
+        std::cout << "Scaling: " << config.count_simulations << " paths per thread, up to " << max_threads << " threads" << std::endl;
+        ::separator();
+        double single_thread_throughput = 0;
+        for (std::size_t t : counts_threads)
+        {
+            pinned_monte_carlo_type mc{t, true};
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            type::simulate_pinned(mc, config.count_simulations * t, xsprt_null, nullptr, false, nullptr, nullptr);
+            std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+
+            double elapsed_seconds = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() / static_cast<double>(1'000'000);
+            double throughput = static_cast<double>(config.count_simulations * t) / elapsed_seconds;
+            if (t == 1) single_thread_throughput = throughput;
+            std::cout << std::left <<
+                "threads = " << std::setw(5) << t <<
+                "pinned = " << std::setw(5) << mc.count_pinned() <<
+                "paths/s = " << std::setw(14) << throughput <<
+                "efficiency = " << std::setw(14) << (throughput / (single_thread_throughput * static_cast<double>(t))) <<
+                "reduction ms = " << (std::chrono::duration_cast<std::chrono::microseconds>(mc.reduction_duration()).count() / static_cast<double>(1'000)) << std::endl;
+        } // for (...)
+        ::separator();
+        return ::execution_result::all_good;
+    } // benchmark_scaling(...)
+
+    /** Largest discrepancy, in standard errors, between two estimates of the same probabilities. */
+    template <typename t_moment_statistic_type>
+    static value_type discrepancy(const t_moment_statistic_type& x, const t_moment_statistic_type& y) noexcept
+    {
+        const auto x_mean = x.mean();
+        const auto y_mean = y.mean();
+        const auto x_variance = x.variance();
+        const auto y_variance = y.variance();
+        value_type result = 0;
+        for (std::size_t i = 0; i < x_mean.height(); ++i)
+        {
+            for (std::size_t j = 0; j < x_mean.width(); ++j)
+            {
+                value_type difference = std::abs(x_mean(i, j) - y_mean(i, j));
+                if (difference == 0) continue;
+                value_type variance = x_variance(i, j) / static_cast<value_type>(x.count()) + y_variance(i, j) / static_cast<value_type>(y.count());
+                value_type z = (variance > 0) ? (difference / std::sqrt(variance)) : std::numeric_limits<value_type>::infinity();
+                if (z > result) result = z;
+            } // for (...)
+        } // for (...)
+        return result;
+    } // discrepancy(...)
+
+    /** @brief Checks the change of measure of forced decisions.
+     *  @details Paths are truncated after a few observations, so that most cells are decided by truncation.
+     *  The direct error estimates of the null simulation and the importance error estimates of the alternative simulation
+     *  (and vice versa) estimate the same probabilities, and have to agree within their standard errors.
+     */
+    static ::execution_result check_truncation(const std::filesystem::path& config_path) noexcept
+    {
+        constexpr std::size_t truncated_sample_size = 4;
+        constexpr value_type max_discrepancy = 6;
+
+        config_type config{};
+        ::execution_result result = type::try_read_config(config_path, config);
+        if (result != ::execution_result::all_good) return result;
+
+        extra_thresholds_type extra_thresholds{};
+        result = type::try_get_extra_thresholds(config, extra_thresholds);
+        if (result != ::execution_result::all_good) return result;
+
+        statistic_type xsprt_null{config.model, config.asprt_thresholds, config.gsprt_thresholds,
+            0, config.model.weakest_signal_strength(), config.anticipated_sample_size.first, extra_thresholds};
+        statistic_type xsprt_alternative{config.model, config.asprt_thresholds, config.gsprt_thresholds,
+            config.model.weakest_signal_strength(), 0, config.anticipated_sample_size.second, extra_thresholds};
+        xsprt_null.truncate_at(truncated_sample_size);
+        xsprt_alternative.truncate_at(truncated_sample_size);
+
+        ::separator();
+        std::cout << "Truncation check: " << config.count_simulations << " paths per hypothesis, truncated at " << truncated_sample_size << std::endl;
+        ::separator();
+        aggregator_type null_output = type::simulate(config.count_simulations, xsprt_null, nullptr, false, config.pin_threads, config.pipeline);
+        aggregator_type alternative_output = type::simulate(config.count_simulations, xsprt_alternative, nullptr, false, config.pin_threads, config.pipeline);
+        ::separator();
+
+        bool is_consistent = true;
+        for (std::size_t k = 0; k < statistic_type::count_extra_rules + 2; ++k)
+        {
+            std::string name = (k == 0) ? "ASPRT" : ((k == 1) ? "GSPRT" : std::string(statistic_type::extra_rule_names[k - 2]));
+            value_type false_alarm = type::discrepancy(null_output.direct_error_indicator().rule(k), alternative_output.importance_error_indicator().rule(k));
+            value_type missed_detection = type::discrepancy(alternative_output.direct_error_indicator().rule(k), null_output.importance_error_indicator().rule(k));
+            value_type forced = null_output.forced_decision_indicator().rule(k).mean()(0, 0);
+            std::cout << std::left << std::setw(8) << name <<
+                "forced = " << std::setw(14) << forced <<
+                "false alarm z = " << std::setw(14) << false_alarm <<
+                "missed detection z = " << missed_detection << std::endl;
+            if (false_alarm > max_discrepancy || missed_detection > max_discrepancy) is_consistent = false;
+        } // for (...)
+        std::cout << "Truncation check " << (is_consistent ? "passed." : "failed.") << std::endl;
+        ::separator();
+        return is_consistent ? ::execution_result::all_good : ::execution_result::truncation_check_failed;
+    } // check_truncation(...)
+
+    static range_type range_of(const typename thresholds_type::first_type& thresholds) noexcept
+    {
+        range_type result{thresholds[0], thresholds[0]};
+        for (value_type x : thresholds)
+        {
+            if (x < result.first) result.first = x;
+            if (x > result.second) result.second = x;
+        } // for (...)
+        return result;
+    } // range_of(...)
+
+    /** @brief Searches for thresholds meeting the target error probabilities, adding paths until the estimates are precise enough.
+     *  @details Every recorded path is kept until the search ends. Fails when the next batch of paths would take more
+     *  than the configured "max memory", reporting the thresholds found on the paths recorded so far.
+     */
+    static ::execution_result calibrate(const config_type& config, const extra_thresholds_type& extra_thresholds) noexcept
+    {
+        using caps_type = typename calibration_simulator_type::caps_type;
+        constexpr std::size_t count_rules = calibration_simulator_type::count_rules;
+
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        value_type weakest_signal_strength = config.model.weakest_signal_strength();
+
+        // Search ranges of every rule; only the parts of the paths between the lower and upper ends are recorded.
+        std::array<std::pair<range_type, range_type>, count_rules> ranges{};
+        ranges[0] = {type::range_of(config.asprt_thresholds.first), type::range_of(config.asprt_thresholds.second)};
+        ranges[1] = {type::range_of(config.gsprt_thresholds.first), type::range_of(config.gsprt_thresholds.second)};
+        for (std::size_t k = 0; k < statistic_type::count_extra_rules; ++k)
+            ranges[2 + k] = {type::range_of(extra_thresholds[k].first), type::range_of(extra_thresholds[k].second)};
+
+        caps_type floors{};
+        caps_type caps{};
+        for (std::size_t k = 0; k < count_rules; ++k)
+        {
+            floors.rule(k) = {ranges[k].first.first, ranges[k].second.first};
+            caps.rule(k) = {ranges[k].first.second, ranges[k].second.second};
+        } // for (...)
+
+        // Null paths estimate missed detection, alternative paths estimate false alarm.
+        statistic_type xsprt_null{config.model, config.asprt_thresholds, config.gsprt_thresholds,
+            0, weakest_signal_strength, config.anticipated_sample_size.first, extra_thresholds};
+        statistic_type xsprt_alternative{config.model, config.asprt_thresholds, config.gsprt_thresholds,
+            weakest_signal_strength, 0, config.anticipated_sample_size.second, extra_thresholds};
+        // Ladders of paths that reach the maximum sample size are censored there.
+        xsprt_null.truncate_at(config.max_sample_size);
+        xsprt_alternative.truncate_at(config.max_sample_size);
+
+        std::array<calibration_simulator_type, count_threads> null_simulators{};
+        std::array<calibration_simulator_type, count_threads> alternative_simulators{};
         for (std::size_t i = 0; i < count_threads; ++i)
         {
-            std::seed_seq threaded_sequence{1, 7, 2, 9,
-                static_cast<int>(seed_engine()),
-                static_cast<int>(seed_engine())};
-            simulators[i].seed(threaded_sequence);
+            null_simulators[i] = calibration_simulator_type(xsprt_null, floors, caps);
+            alternative_simulators[i] = calibration_simulator_type(xsprt_alternative, floors, caps);
         } // for (...)
+        type::seed(null_simulators);
+        type::seed(alternative_simulators);
+
+        calibration_aggregator_type null_paths{};
+        calibration_aggregator_type alternative_paths{};
+        std::array<ropufu::sequential::gaussian_mean_hypotheses::calibration_result<value_type>, count_rules> results{};
+        const std::size_t max_memory = config.calibration.max_memory() * 1'048'576;
+        bool is_out_of_memory = false;
+        std::size_t count_batch = config.count_simulations;
+        while (count_batch != 0)
+        {
+            if (null_paths.count() != 0)
+            {
+                double bytes_per_path = static_cast<double>(null_paths.memory_usage() + alternative_paths.memory_usage()) / null_paths.count();
+                is_out_of_memory = bytes_per_path * (null_paths.count() + count_batch) > max_memory;
+                if (is_out_of_memory) break;
+            } // if (...)
+
+            calibration_monte_carlo_type null_mc{null_simulators};
+            calibration_monte_carlo_type alternative_mc{alternative_simulators};
+            null_paths(null_mc.execute_sync(count_batch));
+            alternative_paths(alternative_mc.execute_sync(count_batch));
+
+            // Paths from earlier batches are reused: the search only reweights what has been recorded.
+            calibration_solver_type solver{null_paths, alternative_paths};
+            value_type worst_relative_error = 0;
+            for (std::size_t k = 0; k < count_rules; ++k)
+            {
+                results[k] = solver.solve(k, ranges[k].first, ranges[k].second,
+                    config.calibration.false_alarm(), config.calibration.missed_detection());
+                if (results[k].relative_error() > worst_relative_error) worst_relative_error = results[k].relative_error();
+            } // for (...)
+
+            std::size_t count_simulations = null_paths.count();
+            std::cout << "Calibrated on " << count_simulations << " paths per hypothesis; worst relative SE = " << worst_relative_error << std::endl;
+            if (worst_relative_error <= config.calibration.relative_tolerance()) break;
+            is_out_of_memory = null_paths.memory_usage() + alternative_paths.memory_usage() > max_memory;
+            if (is_out_of_memory) break;
+            if (count_simulations >= config.calibration.max_simulations()) break;
+            count_batch = count_simulations; // Double the number of paths.
+            if (count_simulations + count_batch > config.calibration.max_simulations()) count_batch = config.calibration.max_simulations() - count_simulations;
+        } // while (...)
+        ::separator();
+
+        for (std::size_t k = 0; k < count_rules; ++k)
+        {
+            const auto& x = results[k];
+            std::string name = (k == 0) ? "ASPRT" : ((k == 1) ? "GSPRT" : std::string(statistic_type::extra_rule_names[k - 2]));
+            std::cout << name << " calibrated thresholds:" << std::endl;
+            std::cout << "first = " << x.thresholds.first <<
+                " (95% CI [" << x.vertical_interval.first << ", " << x.vertical_interval.second << "])" << std::endl;
+            std::cout << "second = " << x.thresholds.second <<
+                " (95% CI [" << x.horizontal_interval.first << ", " << x.horizontal_interval.second << "])" << std::endl;
+            std::cout << "False alarm = " << x.false_alarm.value << ", SE = " << x.false_alarm.standard_error << std::endl;
+            std::cout << "Missed detection = " << x.missed_detection.value << ", SE = " << x.missed_detection.standard_error << std::endl;
+            std::cout << "Null sample size = " << x.null_sample_size.value << ", SE = " << x.null_sample_size.standard_error << std::endl;
+            std::cout << "Alternative sample size = " << x.alternative_sample_size.value << ", SE = " << x.alternative_sample_size.standard_error << std::endl;
+            if (x.is_saturated) std::cout << "Targets not met within the threshold ranges." << std::endl;
+            ::separator();
+        } // for (...)
+
+        std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+        double elapsed_seconds = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() / static_cast<double>(1'000);
+        std::cout << "Total elapsed time: " << elapsed_seconds << " seconds." << std::endl;
+        ::separator();
+
+        if (is_out_of_memory)
+        {
+            std::cout << "Calibration stopped short of the relative tolerance: more paths would exceed the max memory of " <<
+                config.calibration.max_memory() << " MB. Raise \"max memory\" or narrow the threshold ranges." << std::endl;
+            return ::execution_result::calibration_memory_exceeded;
+        } // if (...)
+        return ::execution_result::all_good;
+    } // calibrate(...)
+
+    /** @brief Runs \p count_simulations simulations, reporting on the workers and the noise they consumed.
+     *  @param trace If not null, noise is either recorded to or replayed from \p trace.
+     *  @param is_pinned If set, worker threads are pinned to cores and construct their own simulators.
+     *  @param pipeline_settings If not empty, noise is generated by dedicated producer threads.
+     */
+    static aggregator_type simulate(std::size_t count_simulations, const statistic_type& xsprt,
+        noise_trace_type* trace, bool is_recording, bool is_pinned,
+        const ropufu::sequential::gaussian_mean_hypotheses::noise_pipeline_settings& pipeline_settings) noexcept
+    {
+        std::unique_ptr<noise_pipeline_type> pipeline = nullptr;
+        if (!pipeline_settings.empty())
+        {
+            std::size_t block_length = simulator_type::block_size_for(xsprt.anticipated_sample_size()) * xsprt.model().count_channels();
+            pipeline = std::make_unique<noise_pipeline_type>(pipeline_settings, count_threads, block_length,
+                type::make_seeds(pipeline_settings.count_producers()));
+        } // if (...)
+
+        noise_usage_type usage{};
+        aggregator_type output{};
+        if (is_pinned)
+        {
+            pinned_monte_carlo_type mc{count_threads, true};
+            output = type::simulate_pinned(mc, count_simulations, xsprt, trace, is_recording, pipeline.get(), &usage);
+            std::cout << "Pinned workers: " << mc.count_pinned() << " of " << count_threads << std::endl;
+            std::cout << "Reduction time: " << (std::chrono::duration_cast<std::chrono::microseconds>(mc.reduction_duration()).count() / static_cast<double>(1'000)) << " ms" << std::endl;
+        } // if (...)
+        else
+        {
+            std::array<simulator_type, count_threads> simulators{};
+            for (std::size_t i = 0; i < count_threads; ++i)
+                simulators[i] = simulator_type(xsprt);
+            type::seed(simulators);
+            if (pipeline != nullptr)
+            {
+                for (std::size_t i = 0; i < count_threads; ++i) simulators[i].attach_feed(pipeline->consumer(i));
+            } // if (...)
+            for (simulator_type& x : simulators) x.count_usage_in(usage);
+            if (trace != nullptr)
+            {
+                for (simulator_type& x : simulators)
+                {
+                    if (is_recording) x.record_to(*trace);
+                    else x.replay_from(*trace);
+                } // for (...)
+            } // if (...)
+
+            monte_carlo_type mc{simulators};
+            output = mc.execute_sync(count_simulations);
+        } // else (...)
+        if (pipeline != nullptr)
+        {
+            pipeline->stop();
+            ropufu::sequential::gaussian_mean_hypotheses::wait_statistics producer_waits = pipeline->producer_waits();
+            ropufu::sequential::gaussian_mean_hypotheses::wait_statistics consumer_waits = pipeline->consumer_waits();
+            std::cout << "Noise pipeline: " << pipeline->count_producers() << " producers, " << pipeline->count_consumers() << " consumers, " <<
+                pipeline->count_blocks() << " blocks" << std::endl;
+            std::cout << "Producers waited " << producer_waits.count_waits << " times, " <<
+                std::chrono::duration_cast<std::chrono::milliseconds>(producer_waits.duration).count() << " ms in total" << std::endl;
+            std::cout << "Consumers waited " << consumer_waits.count_waits << " times, " <<
+                std::chrono::duration_cast<std::chrono::milliseconds>(consumer_waits.duration).count() << " ms in total" << std::endl;
+        } // if (...)
+        if (usage.count_generated() != 0)
+        {
+            double wasted_percent = 100 * static_cast<double>(usage.count_wasted()) / static_cast<double>(usage.count_generated());
+            std::cout << "Noise samples: " << usage.count_generated() << " generated, " <<
+                usage.count_wasted() << " wasted (" << wasted_percent << "%)" << std::endl;
+        } // if (...)
+        return output;
+    } // simulate(...)
+
+    /** Canonical description of everything that determines the distribution of the results of \p xsprt. */
+    static std::string results_key(const config_type& config, const statistic_type& xsprt) noexcept
+    {
+        nlohmann::json rules = nlohmann::json::array();
+        for (std::size_t k = 0; k < statistic_type::count_extra_rules; ++k)
+        {
+            std::string_view name = statistic_type::extra_rule_names[k];
+            rules.push_back({
+                {"name", name},
+                {"parameters", statistic_type::extra_rule_parameters[k]},
+                {"thresholds", *config.thresholds_for(name)}
+            });
+        } // for (...)
+
+        // The mangled name covers the engine, the sampler, and the rule types; the first output of a default engine guards against
+        // engines of the same name generating different sequences.
+        engine_type default_engine{};
+        nlohmann::json simulator = {
+            {"type", typeid(simulator_type).name()},
+            {"revision", statistic_type::revision},
+            {"engine first output", default_engine()}
+        };
+
+        nlohmann::json key = {
+            {"simulator", simulator},
+            {"model", config.model},
+            {"signal fingerprint", config.model.signal_fingerprint().to_string()},
+            {"ASPRT thresholds", config.asprt_thresholds},
+            {"GSPRT thresholds", config.gsprt_thresholds},
+            {"rules", rules},
+            {"simulated signal strength", xsprt.simulated_signal_strength()},
+            {"change of measure signal strength", xsprt.change_of_measure_signal_strength()},
+            {"anticipated sample size", xsprt.anticipated_sample_size()},
+            {"max sample size", xsprt.max_sample_size()},
+            {"value size", sizeof(value_type)}
+        };
+        return key.dump();
+    } // results_key(...)
+
+    /** @brief Simulates \p xsprt until \c config.count_simulations paths have been accounted for, and reports the results.
+     *  @details If a results store is configured, paths simulated by earlier runs with the same setup are loaded from it,
+     *  only the missing ones are simulated, and the merged results are written back.
+     *  @param trace If not null, noise is either recorded to or replayed from \p trace; the store is then bypassed.
+     */
+    static void run(const config_type& config, const statistic_type& xsprt, noise_trace_type* trace, bool is_recording) noexcept
+    {
+        using results_store_type = ropufu::sequential::gaussian_mean_hypotheses::results_store<aggregator_type>;
+        using results_lookup = ropufu::sequential::gaussian_mean_hypotheses::results_lookup;
+
+        std::chrono::steady_clock::time_point start{};
+        std::chrono::steady_clock::time_point end{};
+
+        if (trace != nullptr) trace->rewind();
 
         // ========================= Begin simulation ===============================
         start = std::chrono::steady_clock::now();
         ::separator();
-        std::cout << "Simulations: " << count_simulations << std::endl;
+
+        // Earlier results of the same setup.
+        results_store_type store{config.store};
+        bool is_storing = !config.store.empty() && trace == nullptr;
+        std::string key = is_storing ? type::results_key(config, xsprt) : std::string{};
+        aggregator_type stored{};
+        if (!config.store.empty() && trace != nullptr)
+            std::cout << "Results store: bypassed, since paths topped up later would replay the same noise." << std::endl;
+        if (is_storing)
+        {
+            try
+            {
+                switch (store.try_load(key, stored))
+                {
+                case results_lookup::found:
+                    std::cout << "Results store: " << stored.count_paths() << " paths loaded from " << store.path_of(key).string() << std::endl;
+                    break;
+                case results_lookup::mismatched:
+                    std::cout << "Results store: " << store.path_of(key).string() << " was written for a different setup or version, and will be replaced." << std::endl;
+                    break;
+                default:
+                    break;
+                } // switch (...)
+            } // try
+            catch (const std::runtime_error& e)
+            {
+                std::cout << "Results store: " << e.what() << " Starting over." << std::endl;
+                stored = {};
+            } // catch (...)
+        } // if (...)
+
+        std::size_t count_stored = stored.count_paths();
+        std::size_t count_simulations = (config.count_simulations > count_stored) ? (config.count_simulations - count_stored) : 0;
+        std::cout << "Simulations: " << count_simulations;
+        if (count_stored != 0) std::cout << " (" << count_stored << " stored)";
+        std::cout << std::endl;
         std::cout << "Simulated signal strength: " << xsprt.simulated_signal_strength() << std::endl;
         std::cout << "Change of measure signal strength: " << xsprt.change_of_measure_signal_strength() << std::endl;
+        if (trace != nullptr) std::cout << "Noise trace: " << (is_recording ? "recording " : "replaying ") <<
+            trace->count_paths() << " paths, up to " << trace->samples_per_path() << " samples each" << std::endl;
+
+        aggregator_type output = std::move(stored);
+        if (count_simulations != 0)
+        {
+            aggregator_type simulated = type::simulate(count_simulations, xsprt, trace, is_recording, config.pin_threads, config.pipeline);
+            if (count_stored == 0) output = std::move(simulated);
+            else output(simulated);
+        } // if (...)
+        if (is_storing && count_simulations != 0)
+        {
+            try
+            {
+                store.store(key, output);
+                std::cout << "Results store: " << output.count_paths() << " paths saved to " << store.path_of(key).string() << std::endl;
+            } // try
+            catch (const std::runtime_error& e)
+            {
+                std::cout << "Results store: " << e.what() << std::endl;
+            } // catch (...)
+        } // if (...)
         ::separator();
+        if (trace != nullptr && is_recording) trace->flush();
 
-        monte_carlo_type mc{simulators};
-        aggregator_type output = mc.execute_sync(count_simulations);
+        ::cat_path_lengths(output.path_length_distribution(), output.longest_path(), output.count_truncated_paths());
+        ::separator();
         
         std::cout << "ASPRT sample size:" << std::endl;
         ::cat(output.sample_size().adaptive_sprt);
@@ -138,6 +699,23 @@ struct program
         std::cout << "GSPRT sample size:" << std::endl;
         ::cat(output.sample_size().generalized_sprt);
         ::separator();
+
+        std::cout << "ASPRT sample size quantiles:" << std::endl;
+        ::cat_quantiles(output.stopping_time_distribution().adaptive_sprt);
+        ::separator();
+        std::cout << "GSPRT sample size quantiles:" << std::endl;
+        ::cat_quantiles(output.stopping_time_distribution().generalized_sprt);
+        ::separator();
+
+        if (xsprt.max_sample_size() != 0)
+        {
+            std::cout << "ASPRT forced decisions (fraction of paths):" << std::endl;
+            ::cat(output.forced_decision_indicator().adaptive_sprt);
+            ::separator();
+            std::cout << "GSPRT forced decisions (fraction of paths):" << std::endl;
+            ::cat(output.forced_decision_indicator().generalized_sprt);
+            ::separator();
+        } // if (...)
         
         std::cout << "ASPRT direct error (log base 10):" << std::endl;
         ::cat(output.direct_error_indicator().adaptive_sprt, [] (auto x) { return -std::log10(x); });
@@ -153,6 +731,29 @@ struct program
         ::cat(output.importance_error_indicator().generalized_sprt, [] (auto x) { return -std::log10(x); });
         ::separator();
 
+        for (std::size_t k = 0; k < statistic_type::count_extra_rules; ++k)
+        {
+            std::string name{statistic_type::extra_rule_names[k]};
+            std::cout << name << " sample size:" << std::endl;
+            ::cat(output.sample_size().extra_rules[k]);
+            ::separator();
+            std::cout << name << " sample size quantiles:" << std::endl;
+            ::cat_quantiles(output.stopping_time_distribution().extra_rules[k]);
+            ::separator();
+            if (xsprt.max_sample_size() != 0)
+            {
+                std::cout << name << " forced decisions (fraction of paths):" << std::endl;
+                ::cat(output.forced_decision_indicator().extra_rules[k]);
+                ::separator();
+            } // if (...)
+            std::cout << name << " direct error (log base 10):" << std::endl;
+            ::cat(output.direct_error_indicator().extra_rules[k], [] (auto x) { return -std::log10(x); });
+            ::separator();
+            std::cout << name << " importance error (log base 10):" << std::endl;
+            ::cat(output.importance_error_indicator().extra_rules[k], [] (auto x) { return -std::log10(x); });
+            ::separator();
+        } // for (...)
+
         end = std::chrono::steady_clock::now();
         // ========================= End simulation =================================
 
@@ -163,40 +764,117 @@ struct program
 
     static ::execution_result execute(const std::filesystem::path& config_path) noexcept
     {
-        nlohmann::json j{};
-        if (!type::try_read_json(config_path, j))
+        config_type config{};
+        ::execution_result result = type::try_read_config(config_path, config);
+        if (result != ::execution_result::all_good) return result;
+
+        extra_thresholds_type extra_thresholds{};
+        result = type::try_get_extra_thresholds(config, extra_thresholds);
+        if (result != ::execution_result::all_good) return result;
+
+        if (!config.calibration.empty())
         {
-            std::cout << "Failed to read config file." << std::endl;
-            return ::execution_result::failed_to_read_config_file;
+            return type::calibrate(config, extra_thresholds);
         } // if (...)
 
-        config_type config{};
-        if (!ropufu::noexcept_json::try_get(j, config))
+        // Common random numbers: the first simulation records the noise, the rest replay it.
+        std::unique_ptr<noise_trace_type> trace = nullptr;
+        bool is_recording = config.trace.mode() == ropufu::sequential::gaussian_mean_hypotheses::noise_trace_mode::record;
+        try
         {
-            std::cout << "Failed to parse config file." << std::endl;
-            return ::execution_result::failed_to_parse_config_file;
-        } // if (...)
+            switch (config.trace.mode())
+            {
+            case ropufu::sequential::gaussian_mean_hypotheses::noise_trace_mode::record:
+                trace = std::make_unique<noise_trace_type>(config.trace.path(), config.count_simulations, config.trace.samples_per_path(), config.model.count_channels());
+                break;
+            case ropufu::sequential::gaussian_mean_hypotheses::noise_trace_mode::replay:
+                trace = std::make_unique<noise_trace_type>(config.trace.path(), config.model.count_channels());
+                break;
+            default:
+                break;
+            } // switch (...)
+        } // try
+        catch (const std::runtime_error& e)
+        {
+            std::cout << "Failed to open noise trace: " << e.what() << std::endl;
+            return ::execution_result::failed_to_open_noise_trace;
+        } // catch (...)
 
         // First simulation: observations from \Pr_0, change of measure to \Pr_1.
         statistic_type xsprt_null{config.model, config.asprt_thresholds, config.gsprt_thresholds,
-            0, config.model.weakest_signal_strength(), config.anticipated_sample_size.first};
-        type::run(config.count_simulations, xsprt_null);
+            0, config.model.weakest_signal_strength(), config.anticipated_sample_size.first, extra_thresholds};
+        xsprt_null.truncate_at(config.max_sample_size);
+        type::run(config, xsprt_null, trace.get(), is_recording);
         
         // First simulation: observations from \Pr_1, change of measure to \Pr_0.
         statistic_type xsprt_alternative{config.model, config.asprt_thresholds, config.gsprt_thresholds,
-            config.model.weakest_signal_strength(), 0, config.anticipated_sample_size.second};
-        type::run(config.count_simulations, xsprt_alternative);
+            config.model.weakest_signal_strength(), 0, config.anticipated_sample_size.second, extra_thresholds};
+        xsprt_alternative.truncate_at(config.max_sample_size);
+        type::run(config, xsprt_alternative, trace.get(), false);
 
         return ::execution_result::all_good;
     } // execute(...)
 }; // struct program
 
-int main()
+/** @brief Chooses the instruction set and reports it.
+ *  @details Called once at startup: every simulated path, its aggregation, and the channel kernels then run on the chosen instructions.
+ *  @param name Instruction set requested on the command line, if any; detected from the CPU otherwise.
+ */
+template <typename t_value_type>
+bool select_kernels(std::string_view name) noexcept
+{
+    namespace kernels = ropufu::sequential::gaussian_mean_hypotheses::kernels;
+    kernels::instruction_set detected = kernels::detect();
+    kernels::instruction_set requested = detected;
+    if (!name.empty() && !kernels::try_parse(name, requested))
+    {
+        std::cout << "Unknown instruction set: " << name << "." << std::endl;
+        return false;
+    } // if (...)
+    if (!kernels::select(requested))
+    {
+        std::cout << "Instruction set " << kernels::to_string(requested) << " is not supported on this machine." << std::endl;
+        return false;
+    } // if (...)
+
+    std::cout << "Instruction set: " << kernels::to_string(kernels::selected<t_value_type>()) <<
+        " (detected " << kernels::to_string(detected) << ")." << std::endl;
+    return true;
+} // select_kernels(...)
+
+/** @brief Usage:
+ *  simulator.out [--kernels <scalar|avx2|avx512>] [--scaling] [--check-truncation]
+ *  --kernels           Instruction set the paths are simulated and aggregated with. Under -ffp-contract=fast, GCC's default
+ *                      for C++, the avx2 and avx512 variants fuse multiply-adds, so their results differ from scalar in the last bits.
+ *  --scaling           Measures throughput of pinned workers instead of running the simulation.
+ *  --check-truncation  Checks that direct and importance error estimates agree when most decisions are forced.
+ */
+int main(int argc, char* argv[])
 {
     using value_type = double;
     using engine_type = std::mt19937_64;
     constexpr std::size_t count_threads = 4;
+    using program_type = ::program<value_type, engine_type, count_threads,
+        ropufu::sequential::gaussian_mean_hypotheses::cusum_rule<value_type>,
+        ropufu::sequential::gaussian_mean_hypotheses::mixture_sprt_rule<value_type>,
+        ropufu::sequential::gaussian_mean_hypotheses::two_sprt_rule<value_type>>;
+
+    std::string_view kernels_name = "";
+    bool is_scaling_benchmark = false;
+    bool is_truncation_check = false;
+    for (int k = 1; k < argc; ++k)
+    {
+        std::string_view argument = argv[k];
+        if (argument == "--scaling") is_scaling_benchmark = true;
+        else if (argument == "--check-truncation") is_truncation_check = true;
+        else if (argument == "--kernels" && k + 1 < argc) kernels_name = argv[++k];
+        else return static_cast<int>(::execution_result::invalid_arguments);
+    } // for (...)
+    if (!::select_kernels<value_type>(kernels_name)) return static_cast<int>(::execution_result::invalid_arguments);
 
-    ::execution_result result = ::program<value_type, engine_type, count_threads>::execute("./config.json");
+    ::execution_result result =
+        is_scaling_benchmark ? program_type::benchmark_scaling("./config.json") :
+        is_truncation_check ? program_type::check_truncation("./config.json") :
+        program_type::execute("./config.json");
     return static_cast<int>(result);
 } // main(...)
@@ -0,0 +1,172 @@
+
+#ifndef ROPUFU_SEQUENTIAL_GAUSSIAN_MEAN_HYPOTHESES_MEMORY_MAPPED_FILE_HPP_INCLUDED
+#define ROPUFU_SEQUENTIAL_GAUSSIAN_MEAN_HYPOTHESES_MEMORY_MAPPED_FILE_HPP_INCLUDED
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>    // ::open
+#include <sys/mman.h> // ::mmap, ::munmap, ::msync
+#include <sys/stat.h> // ::fstat
+#include <unistd.h>   // ::close, ::ftruncate
+#endif
+
+#include <cstddef>    // std::size_t, std::byte
+#include <filesystem> // std::filesystem::path
+#include <stdexcept>  // std::runtime_error
+#include <string>     // std::string
+#include <utility>    // std::exchange
+
+namespace ropufu::sequential::gaussian_mean_hypotheses
+{
+    /** Read-write shared memory mapping of an entire file. */
+    struct memory_mapped_file
+    {
+        using type = memory_mapped_file;
+
+    private:
+#ifdef _WIN32
+        HANDLE m_file_handle = INVALID_HANDLE_VALUE;
+        HANDLE m_mapping_handle = nullptr;
+#else
+        int m_file_descriptor = -1;
+#endif
+        std::byte* m_data = nullptr;
+        std::size_t m_size = 0;
+
+        void release() noexcept
+        {
+#ifdef _WIN32
+            if (this->m_data != nullptr) ::UnmapViewOfFile(this->m_data);
+            if (this->m_mapping_handle != nullptr) ::CloseHandle(this->m_mapping_handle);
+            if (this->m_file_handle != INVALID_HANDLE_VALUE) ::CloseHandle(this->m_file_handle);
+            this->m_mapping_handle = nullptr;
+            this->m_file_handle = INVALID_HANDLE_VALUE;
+#else
+            if (this->m_data != nullptr) ::munmap(this->m_data, this->m_size);
+            if (this->m_file_descriptor != -1) ::close(this->m_file_descriptor);
+            this->m_file_descriptor = -1;
+#endif
+            this->m_data = nullptr;
+            this->m_size = 0;
+        } // release(...)
+
+        /** @exception std::runtime_error Mapping failed. */
+        void map(const std::filesystem::path& path, bool do_resize, std::size_t size)
+        {
+#ifdef _WIN32
+            this->m_file_handle = ::CreateFileW(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr,
+                do_resize ? CREATE_ALWAYS : OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+            if (this->m_file_handle == INVALID_HANDLE_VALUE) throw std::runtime_error("Failed to open " + path.string() + ".");
+
+            LARGE_INTEGER file_size{};
+            if (do_resize) file_size.QuadPart = static_cast<LONGLONG>(size);
+            else if (!::GetFileSizeEx(this->m_file_handle, &file_size)) throw std::runtime_error("Failed to query size of " + path.string() + ".");
+            this->m_size = static_cast<std::size_t>(file_size.QuadPart);
+            if (this->m_size == 0) throw std::runtime_error("Cannot map empty file " + path.string() + ".");
+
+            this->m_mapping_handle = ::CreateFileMappingW(this->m_file_handle, nullptr, PAGE_READWRITE,
+                static_cast<DWORD>(file_size.HighPart), file_size.LowPart, nullptr);
+            if (this->m_mapping_handle == nullptr) throw std::runtime_error("Failed to map " + path.string() + ".");
+
+            this->m_data = static_cast<std::byte*>(::MapViewOfFile(this->m_mapping_handle, FILE_MAP_ALL_ACCESS, 0, 0, this->m_size));
+            if (this->m_data == nullptr) throw std::runtime_error("Failed to map " + path.string() + ".");
+#else
+            this->m_file_descriptor = do_resize ?
+                ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644) :
+                ::open(path.c_str(), O_RDWR);
+            if (this->m_file_descriptor == -1) throw std::runtime_error("Failed to open " + path.string() + ".");
+
+            if (do_resize)
+            {
+                if (::ftruncate(this->m_file_descriptor, static_cast<off_t>(size)) != 0) throw std::runtime_error("Failed to resize " + path.string() + ".");
+                this->m_size = size;
+            } // if (...)
+            else
+            {
+                struct ::stat status{};
+                if (::fstat(this->m_file_descriptor, &status) != 0) throw std::runtime_error("Failed to query size of " + path.string() + ".");
+                this->m_size = static_cast<std::size_t>(status.st_size);
+            } // else (...)
+            if (this->m_size == 0) throw std::runtime_error("Cannot map empty file " + path.string() + ".");
+
+            void* data = ::mmap(nullptr, this->m_size, PROT_READ | PROT_WRITE, MAP_SHARED, this->m_file_descriptor, 0);
+            if (data == MAP_FAILED) throw std::runtime_error("Failed to map " + path.string() + ".");
+            this->m_data = static_cast<std::byte*>(data);
+#endif
+        } // map(...)
+
+    public:
+        memory_mapped_file() noexcept = default;
+
+        /** Maps an existing file.
+         *  @exception std::runtime_error Mapping failed.
+         */
+        explicit memory_mapped_file(const std::filesystem::path& path)
+        {
+            try { this->map(path, false, 0); }
+            catch (...) { this->release(); throw; }
+        } // memory_mapped_file(...)
+
+        /** Creates (or truncates) a file of size \p size and maps it.
+         *  @exception std::runtime_error Mapping failed.
+         */
+        memory_mapped_file(const std::filesystem::path& path, std::size_t size)
+        {
+            try { this->map(path, true, size); }
+            catch (...) { this->release(); throw; }
+        } // memory_mapped_file(...)
+
+        memory_mapped_file(const type&) = delete;
+        type& operator =(const type&) = delete;
+
+        memory_mapped_file(type&& other) noexcept
+        {
+            *this = std::move(other);
+        } // memory_mapped_file(...)
+
+        type& operator =(type&& other) noexcept
+        {
+            if (this == &other) return *this;
+            this->release();
+#ifdef _WIN32
+            this->m_file_handle = std::exchange(other.m_file_handle, INVALID_HANDLE_VALUE);
+            this->m_mapping_handle = std::exchange(other.m_mapping_handle, nullptr);
+#else
+            this->m_file_descriptor = std::exchange(other.m_file_descriptor, -1);
+#endif
+            this->m_data = std::exchange(other.m_data, nullptr);
+            this->m_size = std::exchange(other.m_size, 0);
+            return *this;
+        } // operator =(...)
+
+        ~memory_mapped_file() noexcept
+        {
+            this->release();
+        } // ~memory_mapped_file(...)
+
+        std::byte* data() noexcept { return this->m_data; }
+        const std::byte* data() const noexcept { return this->m_data; }
+
+        std::size_t size() const noexcept { return this->m_size; }
+
+        /** Writes modified pages back to the file. */
+        void flush() noexcept
+        {
+            if (this->m_data == nullptr) return;
+#ifdef _WIN32
+            ::FlushViewOfFile(this->m_data, this->m_size);
+#else
+            ::msync(this->m_data, this->m_size, MS_SYNC);
+#endif
+        } // flush(...)
+    }; // struct memory_mapped_file
+} // namespace ropufu::sequential::gaussian_mean_hypotheses
+
+#endif // ROPUFU_SEQUENTIAL_GAUSSIAN_MEAN_HYPOTHESES_MEMORY_MAPPED_FILE_HPP_INCLUDED
@@ -8,6 +8,10 @@
 #include <ropufu/number_traits.hpp>
 #include <ropufu/simple_vector.hpp>
 
+#include "fingerprint.hpp"
+#include "multichannel_signal.hpp"
+#include "signal.hpp"
+
 #include <concepts>    // std::floating_point
 #include <cstddef>     // std::size_t
 #include <functional>  // std::hash
@@ -15,6 +19,7 @@
 #include <stdexcept>   // std::logic_error, std::runtime_error
 #include <string>      // std::string
 #include <string_view> // std::string_view
+#include <vector>      // std::vector
 
 #ifdef ROPUFU_TMP_TYPENAME
 #undef ROPUFU_TMP_TYPENAME
@@ -49,18 +54,37 @@ namespace ropufu::sequential::gaussian_mean_hypotheses
         // ~~ Json names ~~
         static constexpr std::string_view jstr_type = "type";
         static constexpr std::string_view jstr_weakest_signal_strength = "weakest signal strength";
+        static constexpr std::string_view jstr_signal = "signal";
+        static constexpr std::string_view jstr_channels = "channels";
 
         friend ropufu::noexcept_json_serializer<type>;
         friend std::hash<type>;
 
+        using signal_type = tabulated_signal<value_type>;
+        using multichannel_signal_type = multichannel_signal<value_type>;
+
     private:
         value_type m_weakest_signal_strength = 1;
+        signal_type m_signal = {};
+        std::vector<signal_type> m_channel_signals = {}; // Empty for single-channel models.
+        multichannel_signal_type m_channels = {};
 
         /** @brief Validates the structure and returns an error message, if any. */
         std::optional<std::string> error_message() const noexcept
         {
             if (!aftermath::is_finite(this->m_weakest_signal_strength)) return "Weakest signal strength must be finite.";
             if (this->m_weakest_signal_strength <= 0) return "Weakest signal strength must be positive.";
+            if (this->m_channel_signals.empty())
+            {
+                if (this->m_signal.is_vanishing()) return "Signal must not vanish.";
+            } // if (...)
+            else
+            {
+                if (!multichannel_signal_type::is_valid(this->m_channel_signals)) return "Channel signals cannot be tabulated jointly.";
+                bool is_vanishing = true;
+                for (const signal_type& x : this->m_channel_signals) if (!x.is_vanishing()) is_vanishing = false;
+                if (is_vanishing) return "Signal must not vanish in every channel.";
+            } // else (...)
             
             return std::nullopt;
         } // error_message(...)
@@ -75,21 +99,64 @@ namespace ropufu::sequential::gaussian_mean_hypotheses
     public:
         model() noexcept = default;
 
-        explicit model(value_type weakest_signal_strength)
-            : m_weakest_signal_strength(weakest_signal_strength)
+        explicit model(value_type weakest_signal_strength, const signal_type& signal = {})
+            : m_weakest_signal_strength(weakest_signal_strength), m_signal(signal)
         {
             this->validate();
         } // model(...)
 
+        /** Multi-channel model: every channel observes its own signal \p channel_signals[c] scaled by the common signal strength, in independent noise. */
+        model(value_type weakest_signal_strength, const std::vector<signal_type>& channel_signals)
+            : m_weakest_signal_strength(weakest_signal_strength), m_channel_signals(channel_signals)
+        {
+            this->validate();
+            if (!this->m_channel_signals.empty()) this->m_channels = multichannel_signal_type(this->m_channel_signals);
+        } // model(...)
+
+        std::size_t count_channels() const noexcept { return this->m_channel_signals.empty() ? 1 : this->m_channel_signals.size(); }
+
+        bool is_multichannel() const noexcept { return !this->m_channel_signals.empty(); }
+
+        /** Joint signal table of a multi-channel model. */
+        const multichannel_signal_type& channels() const noexcept { return this->m_channels; }
+
+        /** Known signal shape of a single-channel model, tabulated with its cumulative energy. */
+        const signal_type& signal() const noexcept { return this->m_signal; }
+
         // Signal as a function of time.
-        constexpr t_value_type signal_at(std::size_t /*time*/) const noexcept { return 1; }
+        value_type signal_at(std::size_t time) const noexcept { return this->m_signal.at(time); }
 
         value_type weakest_signal_strength() const noexcept { return this->m_weakest_signal_strength; }
 
+        /** Fingerprint of the tabulated signals of every channel. */
+        fingerprint signal_fingerprint() const noexcept
+        {
+            fingerprint result{};
+            result.add_bytes(this->m_channel_signals.size());
+            if (this->m_channel_signals.empty()) this->m_signal.add_to(result);
+            for (const signal_type& x : this->m_channel_signals) x.add_to(result);
+            return result;
+        } // signal_fingerprint(...)
+
+        /** Number of observations the signal is known for, if some signal (chirp, file) is not periodic; zero otherwise. */
+        std::size_t horizon() const noexcept
+        {
+            std::size_t result = 0;
+            auto restrict_to = [&result] (const signal_type& x) {
+                if (x.is_periodic()) return;
+                if (result == 0 || x.period() < result) result = x.period();
+            };
+            if (this->m_channel_signals.empty()) restrict_to(this->m_signal);
+            for (const signal_type& x : this->m_channel_signals) restrict_to(x);
+            return result;
+        } // horizon(...)
+
         bool operator ==(const type& other) const noexcept
         {
             return
-                this->m_weakest_signal_strength == other.m_weakest_signal_strength;
+                this->m_weakest_signal_strength == other.m_weakest_signal_strength &&
+                this->m_signal == other.m_signal &&
+                this->m_channel_signals == other.m_channel_signals;
         } // operator ==(...)
 
         bool operator !=(const type& other) const noexcept
@@ -103,6 +170,8 @@ namespace ropufu::sequential::gaussian_mean_hypotheses
                 {type::jstr_type, type::name},
                 {type::jstr_weakest_signal_strength, x.m_weakest_signal_strength}
             };
+            if (x.m_channel_signals.empty()) j[std::string(type::jstr_signal)] = x.m_signal;
+            else j[std::string(type::jstr_channels)] = x.m_channel_signals;
         } // to_json(...)
 
         friend void from_json(const nlohmann::json& j, type& x)
@@ -124,10 +193,29 @@ namespace ropufu
             std::string model_name;
             if (!noexcept_json::required(j, result_type::jstr_type, model_name)) return false;
             if (!noexcept_json::required(j, result_type::jstr_weakest_signal_strength, x.m_weakest_signal_strength)) return false;
-            
+            if (!noexcept_json::optional(j, result_type::jstr_signal, x.m_signal)) return false;
+            if (!noexcept_json::optional(j, result_type::jstr_channels, x.m_channel_signals)) return false;
+
+            // Multi-channel models describe their signals per channel.
+            if (!x.m_channel_signals.empty() && j.contains(std::string(result_type::jstr_signal))) return false;
+            if (x.m_channel_signals.size() == 1)
+            {
+                x.m_signal = x.m_channel_signals.front();
+                x.m_channel_signals.clear();
+            } // if (...)
+
             if (model_name != result_type::name) return false;
             if (x.error_message().has_value()) return false;
 
+            try
+            {
+                if (!x.m_channel_signals.empty()) x.m_channels = typename result_type::multichannel_signal_type(x.m_channel_signals);
+            } // try
+            catch (...)
+            {
+                return false;
+            } // catch (...)
+
             return true;
         } // try_get(...)
     }; // struct noexcept_json_serializer<...>
@@ -144,7 +232,12 @@ namespace std
         result_type operator ()(argument_type const& x) const noexcept
         {
             std::hash<typename argument_type::value_type> signal_strength_hasher{};
-            return signal_strength_hasher(x.m_weakest_signal_strength);
+            std::hash<typename argument_type::signal_type> signal_hasher{};
+            result_type result =
+                (signal_strength_hasher(x.m_weakest_signal_strength) << 1) ^
+                signal_hasher(x.m_signal);
+            for (const auto& channel_signal : x.m_channel_signals) result = (result << 1) ^ (result >> (sizeof(result_type) * 8 - 1)) ^ signal_hasher(channel_signal);
+            return result;
         } // operator ()(...)
     }; // struct hash<...>
 } // namespace std
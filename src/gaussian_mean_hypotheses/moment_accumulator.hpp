@@ -0,0 +1,140 @@
+
+#ifndef ROPUFU_SEQUENTIAL_GAUSSIAN_MEAN_HYPOTHESES_MOMENT_ACCUMULATOR_HPP_INCLUDED
+#define ROPUFU_SEQUENTIAL_GAUSSIAN_MEAN_HYPOTHESES_MOMENT_ACCUMULATOR_HPP_INCLUDED
+
+#include <ropufu/algebra/matrix.hpp>
+
+#include "binary_archive.hpp"
+
+#include <concepts>  // std::floating_point
+#include <cstddef>   // std::size_t
+#include <stdexcept> // std::logic_error, std::runtime_error
+#include <utility>   // std::move
+
+namespace ropufu::sequential::gaussian_mean_hypotheses
+{
+    /** @brief Sample mean and variance of every cell of matrix-valued observations.
+     *  @details Sums are taken of deviations from an anticipated mean, which keeps the variance accurate when the mean is large.
+     *  Unlike \c aftermath::probability::moment_statistic, the sums themselves can be stored and restored exactly.
+     *  @tparam t_observation_value_type Type of the entries of observations.
+     */
+    template <typename t_observation_value_type, std::floating_point t_value_type>
+    struct moment_accumulator
+    {
+        using type = moment_accumulator<t_observation_value_type, t_value_type>;
+        using observation_value_type = t_observation_value_type;
+        using value_type = t_value_type;
+
+        template <typename t_data_type>
+        using matrix_t = ropufu::aftermath::algebra::matrix<t_data_type>;
+
+    private:
+        std::size_t m_count = 0;
+        matrix_t<value_type> m_shift = {};
+        matrix_t<value_type> m_sum = {};
+        matrix_t<value_type> m_sum_of_squares = {};
+
+    public:
+        moment_accumulator() noexcept = default;
+
+        explicit moment_accumulator(const matrix_t<value_type>& anticipated_mean) noexcept
+            : m_shift(anticipated_mean),
+            m_sum(anticipated_mean.height(), anticipated_mean.width()),
+            m_sum_of_squares(anticipated_mean.height(), anticipated_mean.width())
+        {
+        } // moment_accumulator(...)
+
+        std::size_t count() const noexcept { return this->m_count; }
+
+        void observe(const matrix_t<observation_value_type>& value) noexcept
+        {
+            for (std::size_t i = 0; i < this->m_shift.height(); ++i)
+            {
+                for (std::size_t j = 0; j < this->m_shift.width(); ++j)
+                {
+                    value_type deviation = static_cast<value_type>(value(i, j)) - this->m_shift(i, j);
+                    this->m_sum(i, j) += deviation;
+                    this->m_sum_of_squares(i, j) += deviation * deviation;
+                } // for (...)
+            } // for (...)
+            ++this->m_count;
+        } // observe(...)
+
+        /** @brief Pools the observations of \p other with these.
+         *  @exception std::logic_error Accumulators are of different sizes.
+         */
+        void observe(const type& other)
+        {
+            if (other.m_count == 0) return;
+            if (this->m_count == 0)
+            {
+                *this = other;
+                return;
+            } // if (...)
+            if (this->m_shift.height() != other.m_shift.height() || this->m_shift.width() != other.m_shift.width())
+                throw std::logic_error("Accumulators must be of the same size.");
+
+            value_type count = static_cast<value_type>(other.m_count);
+            for (std::size_t i = 0; i < this->m_shift.height(); ++i)
+            {
+                for (std::size_t j = 0; j < this->m_shift.width(); ++j)
+                {
+                    // Re-center the sums of the other accumulator around this shift.
+                    value_type delta = other.m_shift(i, j) - this->m_shift(i, j);
+                    this->m_sum(i, j) += other.m_sum(i, j) + count * delta;
+                    this->m_sum_of_squares(i, j) += other.m_sum_of_squares(i, j) + delta * (2 * other.m_sum(i, j) + count * delta);
+                } // for (...)
+            } // for (...)
+            this->m_count += other.m_count;
+        } // observe(...)
+
+        /** Sample mean of every cell; the anticipated mean if nothing has been observed. */
+        matrix_t<value_type> mean() const noexcept
+        {
+            if (this->m_count == 0) return this->m_shift;
+            value_type count = static_cast<value_type>(this->m_count);
+            return matrix_t<value_type>::generate(this->m_shift.height(), this->m_shift.width(), [this, count] (std::size_t i, std::size_t j) {
+                return this->m_shift(i, j) + this->m_sum(i, j) / count;
+            });
+        } // mean(...)
+
+        /** Unbiased sample variance of every cell; zero if fewer than two observations have been made. */
+        matrix_t<value_type> variance() const noexcept
+        {
+            if (this->m_count < 2) return matrix_t<value_type>(this->m_shift.height(), this->m_shift.width());
+            value_type count = static_cast<value_type>(this->m_count);
+            return matrix_t<value_type>::generate(this->m_shift.height(), this->m_shift.width(), [this, count] (std::size_t i, std::size_t j) {
+                value_type sum = this->m_sum(i, j);
+                return (this->m_sum_of_squares(i, j) - sum * sum / count) / (count - 1);
+            });
+        } // variance(...)
+
+        void write(binary_writer& writer) const
+        {
+            writer.write_size(this->m_count);
+            writer.write_matrix(this->m_shift);
+            writer.write_matrix(this->m_sum);
+            writer.write_matrix(this->m_sum_of_squares);
+        } // write(...)
+
+        /** @exception std::runtime_error Stream ended early, or the stored sums are inconsistent. */
+        void read(binary_reader& reader)
+        {
+            type result{};
+            result.m_count = reader.read_size();
+            reader.read_matrix(result.m_shift);
+            reader.read_matrix(result.m_sum);
+            reader.read_matrix(result.m_sum_of_squares);
+
+            std::size_t height = result.m_shift.height();
+            std::size_t width = result.m_shift.width();
+            if (result.m_sum.height() != height || result.m_sum.width() != width ||
+                result.m_sum_of_squares.height() != height || result.m_sum_of_squares.width() != width)
+                throw std::runtime_error("Stored sums are of different sizes.");
+
+            *this = std::move(result);
+        } // read(...)
+    }; // struct moment_accumulator
+} // namespace ropufu::sequential::gaussian_mean_hypotheses
+
+#endif // ROPUFU_SEQUENTIAL_GAUSSIAN_MEAN_HYPOTHESES_MOMENT_ACCUMULATOR_HPP_INCLUDED
@@ -0,0 +1,131 @@
+
+#ifndef ROPUFU_SEQUENTIAL_GAUSSIAN_MEAN_HYPOTHESES_MULTICHANNEL_SIGNAL_HPP_INCLUDED
+#define ROPUFU_SEQUENTIAL_GAUSSIAN_MEAN_HYPOTHESES_MULTICHANNEL_SIGNAL_HPP_INCLUDED
+
+#include "kernels.hpp"
+#include "signal.hpp"
+
+#include <concepts>  // std::floating_point
+#include <cstddef>   // std::size_t
+#include <numeric>   // std::lcm
+#include <optional>  // std::optional, std::nullopt
+#include <span>      // std::span
+#include <stdexcept> // std::logic_error
+#include <string>    // std::string
+#include <vector>    // std::vector
+
+namespace ropufu::sequential::gaussian_mean_hypotheses
+{
+    /** @brief Known signals of several channels sharing the same signal strength, tabulated jointly.
+     *  @details Row n of the table holds the signal of every channel at time n, padded to a whole number of cache lines,
+     *  so that the per-observation sufficient statistics reduce to a single dot product.
+     *  The table spans the least common multiple of the channel periods.
+     */
+    template <std::floating_point t_value_type>
+    struct multichannel_signal
+    {
+        using type = multichannel_signal<t_value_type>;
+        using value_type = t_value_type;
+        using channel_type = tabulated_signal<value_type>;
+        using table_type = std::vector<value_type, detail::cache_aligned_allocator<value_type>>;
+
+        /** Largest number of entries in the joint table. */
+        static constexpr std::size_t max_table_size = 1 << 24;
+
+    private:
+        std::size_t m_count_channels = 0;
+        std::size_t m_stride = 0;
+        std::size_t m_period = 0;
+        table_type m_table = {}; // Signal of every channel, row by row.
+        std::vector<signal_entry<value_type>> m_energy = {}; // Sum of squared signals across channels, with its cumulative sum.
+
+        /** @brief Validates the structure and returns an error message, if any. */
+        static std::optional<std::string> error_message(const std::vector<channel_type>& channels, std::size_t& period) noexcept
+        {
+            period = 1;
+            if (channels.empty()) return "There must be at least one channel.";
+            for (const channel_type& x : channels)
+            {
+                period = std::lcm(period, x.period());
+                if (period * channels.size() > type::max_table_size) return "Channel periods are too long to be tabulated jointly.";
+            } // for (...)
+            return std::nullopt;
+        } // error_message(...)
+
+    public:
+        multichannel_signal() noexcept = default;
+
+        /** @exception std::logic_error Validation failed. */
+        explicit multichannel_signal(const std::vector<channel_type>& channels)
+            : m_count_channels(channels.size())
+        {
+            std::optional<std::string> message = type::error_message(channels, this->m_period);
+            if (message.has_value()) throw std::logic_error(message.value());
+
+            constexpr std::size_t width = kernels::lanes<value_type>;
+            this->m_stride = width * ((this->m_count_channels + width - 1) / width);
+            this->m_table.resize(this->m_period * this->m_stride);
+            this->m_energy.reserve(this->m_period);
+
+            value_type sum = 0;
+            for (std::size_t k = 0; k < this->m_period; ++k)
+            {
+                value_type* row = this->m_table.data() + k * this->m_stride;
+                value_type energy = 0;
+                for (std::size_t c = 0; c < this->m_count_channels; ++c)
+                {
+                    row[c] = channels[c].at(k + 1);
+                    energy += row[c] * row[c];
+                } // for (...)
+                sum += energy;
+                this->m_energy.push_back({energy, sum});
+            } // for (...)
+        } // multichannel_signal(...)
+
+        /** Checks if \p channels can be tabulated jointly. */
+        static bool is_valid(const std::vector<channel_type>& channels) noexcept
+        {
+            std::size_t period = 0;
+            return !type::error_message(channels, period).has_value();
+        } // is_valid(...)
+
+        std::size_t count_channels() const noexcept { return this->m_count_channels; }
+
+        std::size_t period() const noexcept { return this->m_period; }
+
+        /** Signal of every channel at \p phase. */
+        const value_type* at(const signal_phase& phase) const noexcept
+        {
+            return this->m_table.data() + phase.index * this->m_stride;
+        } // at(...)
+
+        /** Sum of squared signals across channels at \p phase. */
+        value_type energy(const signal_phase& phase) const noexcept
+        {
+            return this->m_energy[phase.index].value;
+        } // energy(...)
+
+        /** Sum of squared signals across channels, up to and including \p phase. */
+        value_type cumulative_squared(const signal_phase& phase) const noexcept
+        {
+            return static_cast<value_type>(phase.count_periods) * this->m_energy.back().cumulative_squared + this->m_energy[phase.index].cumulative_squared;
+        } // cumulative_squared(...)
+
+        /** Moves \p phase to the next observation. */
+        void advance(signal_phase& phase) const noexcept { phase.advance(this->m_period); }
+
+        /** Sum of signal times observation across channels at \p phase. */
+        value_type signal_times(const signal_phase& phase, std::span<const value_type> observations) const noexcept
+        {
+            return kernels::dot(this->at(phase), observations.data(), this->m_count_channels);
+        } // signal_times(...)
+
+        /** Adds the signal of strength \p signal_strength at \p phase to \p noise. */
+        void add_to(const signal_phase& phase, value_type signal_strength, std::span<value_type> noise) const noexcept
+        {
+            kernels::axpy(signal_strength, this->at(phase), noise.data(), this->m_count_channels);
+        } // add_to(...)
+    }; // struct multichannel_signal
+} // namespace ropufu::sequential::gaussian_mean_hypotheses
+
+#endif // ROPUFU_SEQUENTIAL_GAUSSIAN_MEAN_HYPOTHESES_MULTICHANNEL_SIGNAL_HPP_INCLUDED
@@ -0,0 +1,306 @@
+
+#ifndef ROPUFU_SEQUENTIAL_GAUSSIAN_MEAN_HYPOTHESES_NOISE_PIPELINE_HPP_INCLUDED
+#define ROPUFU_SEQUENTIAL_GAUSSIAN_MEAN_HYPOTHESES_NOISE_PIPELINE_HPP_INCLUDED
+
+#include <nlohmann/json.hpp>
+#include <ropufu/noexcept_json.hpp>
+
+#include "spsc_ring.hpp"
+
+#include <array>       // std::array
+#include <atomic>      // std::atomic_bool, std::memory_order_relaxed
+#include <chrono>      // std::chrono::steady_clock, std::chrono::nanoseconds
+#include <cstddef>     // std::size_t
+#include <memory>      // std::unique_ptr, std::make_unique
+#include <optional>    // std::optional, std::nullopt
+#include <random>      // std::seed_seq
+#include <span>        // std::span
+#include <stdexcept>   // std::logic_error, std::runtime_error
+#include <string>      // std::string
+#include <string_view> // std::string_view
+#include <thread>      // std::thread, std::this_thread::yield
+#include <vector>      // std::vector
+
+namespace ropufu::sequential::gaussian_mean_hypotheses
+{
+    struct noise_pipeline_settings;
+
+    void to_json(nlohmann::json& j, const noise_pipeline_settings& x) noexcept;
+    void from_json(const nlohmann::json& j, noise_pipeline_settings& x);
+
+    /** Describes whether noise should be generated on dedicated producer threads, and how many. */
+    struct noise_pipeline_settings
+    {
+        using type = noise_pipeline_settings;
+
+        // ~~ Json names ~~
+        static constexpr std::string_view jstr_producers = "producers";
+        static constexpr std::string_view jstr_ring_blocks = "ring blocks";
+
+        friend ropufu::noexcept_json_serializer<type>;
+
+    private:
+        std::size_t m_count_producers = 0;
+        std::size_t m_ring_blocks = 16;
+
+        /** @brief Validates the structure and returns an error message, if any. */
+        std::optional<std::string> error_message() const noexcept
+        {
+            if (this->m_ring_blocks == 0) return "Ring blocks must be positive.";
+
+            return std::nullopt;
+        } // error_message(...)
+
+    public:
+        noise_pipeline_settings() noexcept = default;
+
+        /** Noise is generated by the simulators themselves. */
+        bool empty() const noexcept { return this->m_count_producers == 0; }
+
+        std::size_t count_producers() const noexcept { return this->m_count_producers; }
+
+        /** Number of noise blocks buffered between a producer and a consumer. */
+        std::size_t ring_blocks() const noexcept { return this->m_ring_blocks; }
+
+        friend void to_json(nlohmann::json& j, const type& x) noexcept
+        {
+            j = nlohmann::json{
+                {type::jstr_producers, x.m_count_producers},
+                {type::jstr_ring_blocks, x.m_ring_blocks}
+            };
+        } // to_json(...)
+
+        friend void from_json(const nlohmann::json& j, type& x)
+        {
+            if (!ropufu::noexcept_json::try_get(j, x))
+                throw std::runtime_error("Parsing <noise_pipeline_settings> failed: " + j.dump());
+        } // from_json(...)
+    }; // struct noise_pipeline_settings
+
+    /** Time one side of a pipeline spent waiting for the other. */
+    struct wait_statistics
+    {
+        /** Number of times the rings were found full (producers) or empty (consumers). */
+        std::size_t count_waits = 0;
+        std::chrono::nanoseconds duration = {};
+
+        void record(std::chrono::nanoseconds wait) noexcept
+        {
+            ++this->count_waits;
+            this->duration += wait;
+        } // record(...)
+
+        wait_statistics& operator +=(const wait_statistics& other) noexcept
+        {
+            this->count_waits += other.count_waits;
+            this->duration += other.duration;
+            return *this;
+        } // operator +=(...)
+    }; // struct wait_statistics
+
+    /** @brief Noise blocks generated on dedicated producer threads, handed to consumers through single-producer single-consumer rings.
+     *  @details There is one ring for every (producer, consumer) pairing: ring r is filled by producer (r mod P) and drained by
+     *  consumer (r mod C), with max(P, C) rings in total. Producers fill whichever of their rings has room;
+     *  consumers read from whichever of their rings has data.
+     */
+    template <typename t_process_type>
+    struct noise_pipeline
+    {
+        using type = noise_pipeline<t_process_type>;
+        using process_type = t_process_type;
+        using container_type = typename process_type::container_type;
+        using value_type = typename container_type::value_type;
+        using ring_type = spsc_ring<container_type>;
+        using clock_type = std::chrono::steady_clock;
+
+        /** Consumer end of the pipeline, to be used by a single thread. */
+        struct alignas(64) feed
+        {
+            friend type;
+
+        private:
+            std::vector<ring_type*> m_rings = {};
+            std::size_t m_next_ring = 0;
+            ring_type* m_held_ring = nullptr;
+            wait_statistics m_waits = {};
+
+            container_type* try_read() noexcept
+            {
+                for (std::size_t k = 0; k < this->m_rings.size(); ++k)
+                {
+                    ring_type* ring = this->m_rings[this->m_next_ring];
+                    if (++this->m_next_ring == this->m_rings.size()) this->m_next_ring = 0;
+                    container_type* slot = ring->try_read();
+                    if (slot == nullptr) continue;
+                    this->m_held_ring = ring;
+                    return slot;
+                } // for (...)
+                return nullptr;
+            } // try_read(...)
+
+        public:
+            /** Next block of noise; it may be modified in place, and stays valid until the following call. */
+            std::span<value_type> next() noexcept
+            {
+                if (this->m_held_ring != nullptr) this->m_held_ring->commit_read();
+                this->m_held_ring = nullptr;
+
+                container_type* slot = this->try_read();
+                if (slot == nullptr) [[unlikely]]
+                {
+                    clock_type::time_point start = clock_type::now();
+                    while (slot == nullptr)
+                    {
+                        std::this_thread::yield();
+                        slot = this->try_read();
+                    } // while (...)
+                    this->m_waits.record(clock_type::now() - start);
+                } // if (...)
+                return {slot->data(), slot->size()};
+            } // next(...)
+
+            const wait_statistics& waits() const noexcept { return this->m_waits; }
+        }; // struct feed
+
+    private:
+        struct alignas(64) producer_slot
+        {
+            wait_statistics waits = {};
+            std::size_t count_blocks = 0;
+        }; // struct producer_slot
+
+        std::vector<std::unique_ptr<ring_type>> m_rings = {};
+        std::vector<std::unique_ptr<feed>> m_feeds = {};
+        std::vector<producer_slot> m_producer_slots = {};
+        std::vector<std::thread> m_producers = {};
+        std::atomic_bool m_is_stopping = false;
+
+        void produce(std::size_t producer_index, std::array<int, 2> seed) noexcept
+        {
+            process_type noise{};
+            std::seed_seq sequence{3, 1, 4, 1, 5, seed[0], seed[1]};
+            noise.seed(sequence);
+
+            std::vector<ring_type*> rings{};
+            for (std::size_t r = producer_index; r < this->m_rings.size(); r += this->m_producer_slots.size()) rings.push_back(this->m_rings[r].get());
+
+            producer_slot& slot = this->m_producer_slots[producer_index];
+            while (!this->m_is_stopping.load(std::memory_order_relaxed))
+            {
+                bool has_written = false;
+                for (ring_type* ring : rings)
+                {
+                    container_type* block = ring->try_write();
+                    if (block == nullptr) continue;
+                    noise.next(*block);
+                    ring->commit_write();
+                    ++slot.count_blocks;
+                    has_written = true;
+                } // for (...)
+                if (has_written) continue;
+
+                // Every ring is full: wait for consumers to catch up.
+                clock_type::time_point start = clock_type::now();
+                bool has_room = false;
+                while (!has_room && !this->m_is_stopping.load(std::memory_order_relaxed))
+                {
+                    std::this_thread::yield();
+                    for (ring_type* ring : rings) if (ring->try_write() != nullptr) has_room = true;
+                } // while (...)
+                slot.waits.record(clock_type::now() - start);
+            } // while (...)
+        } // produce(...)
+
+    public:
+        /** @param block_length Number of noise values in every block.
+         *  @param seeds Seeds of every producer.
+         */
+        noise_pipeline(const noise_pipeline_settings& settings, std::size_t count_consumers, std::size_t block_length,
+            const std::vector<std::array<int, 2>>& seeds)
+        {
+            std::size_t count_producers = settings.count_producers();
+            if (count_producers == 0 || count_consumers == 0) throw std::logic_error("Pipeline must have producers and consumers.");
+            if (seeds.size() < count_producers) throw std::logic_error("Every producer must be seeded.");
+
+            std::size_t count_rings = (count_producers > count_consumers) ? count_producers : count_consumers;
+            container_type prototype = container_type(block_length);
+            for (std::size_t r = 0; r < count_rings; ++r) this->m_rings.push_back(std::make_unique<ring_type>(settings.ring_blocks(), prototype));
+            for (std::size_t c = 0; c < count_consumers; ++c)
+            {
+                this->m_feeds.push_back(std::make_unique<feed>());
+                for (std::size_t r = c; r < count_rings; r += count_consumers) this->m_feeds.back()->m_rings.push_back(this->m_rings[r].get());
+            } // for (...)
+
+            this->m_producer_slots.resize(count_producers);
+            this->m_producers.reserve(count_producers);
+            for (std::size_t p = 0; p < count_producers; ++p)
+                this->m_producers.emplace_back([this, p, seed = seeds[p]] () { this->produce(p, seed); });
+        } // noise_pipeline(...)
+
+        noise_pipeline(const type&) = delete;
+        type& operator =(const type&) = delete;
+
+        ~noise_pipeline() noexcept
+        {
+            this->stop();
+        } // ~noise_pipeline(...)
+
+        std::size_t count_producers() const noexcept { return this->m_producer_slots.size(); }
+
+        std::size_t count_consumers() const noexcept { return this->m_feeds.size(); }
+
+        /** Consumer end with index \p index. */
+        feed& consumer(std::size_t index) noexcept { return *this->m_feeds[index]; }
+
+        /** Total waits of all producers; only meaningful once the pipeline has been stopped. */
+        wait_statistics producer_waits() const noexcept
+        {
+            wait_statistics result{};
+            for (const producer_slot& x : this->m_producer_slots) result += x.waits;
+            return result;
+        } // producer_waits(...)
+
+        /** Total waits of all consumers. */
+        wait_statistics consumer_waits() const noexcept
+        {
+            wait_statistics result{};
+            for (const std::unique_ptr<feed>& x : this->m_feeds) result += x->waits();
+            return result;
+        } // consumer_waits(...)
+
+        /** Number of blocks generated; only meaningful once the pipeline has been stopped. */
+        std::size_t count_blocks() const noexcept
+        {
+            std::size_t result = 0;
+            for (const producer_slot& x : this->m_producer_slots) result += x.count_blocks;
+            return result;
+        } // count_blocks(...)
+
+        /** Stops and joins the producers; consumers must not request any more blocks. */
+        void stop() noexcept
+        {
+            this->m_is_stopping.store(true, std::memory_order_relaxed);
+            for (std::thread& x : this->m_producers) if (x.joinable()) x.join();
+        } // stop(...)
+    }; // struct noise_pipeline
+} // namespace ropufu::sequential::gaussian_mean_hypotheses
+
+namespace ropufu
+{
+    template <>
+    struct noexcept_json_serializer<ropufu::sequential::gaussian_mean_hypotheses::noise_pipeline_settings>
+    {
+        using result_type = ropufu::sequential::gaussian_mean_hypotheses::noise_pipeline_settings;
+        static bool try_get(const nlohmann::json& j, result_type& x) noexcept
+        {
+            if (!noexcept_json::required(j, result_type::jstr_producers, x.m_count_producers)) return false;
+            if (!noexcept_json::optional(j, result_type::jstr_ring_blocks, x.m_ring_blocks)) return false;
+
+            if (x.error_message().has_value()) return false;
+
+            return true;
+        } // try_get(...)
+    }; // struct noexcept_json_serializer<...>
+} // namespace ropufu
+
+#endif // ROPUFU_SEQUENTIAL_GAUSSIAN_MEAN_HYPOTHESES_NOISE_PIPELINE_HPP_INCLUDED
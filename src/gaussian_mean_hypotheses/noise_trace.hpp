@@ -0,0 +1,258 @@
+
+#ifndef ROPUFU_SEQUENTIAL_GAUSSIAN_MEAN_HYPOTHESES_NOISE_TRACE_HPP_INCLUDED
+#define ROPUFU_SEQUENTIAL_GAUSSIAN_MEAN_HYPOTHESES_NOISE_TRACE_HPP_INCLUDED
+
+#include <nlohmann/json.hpp>
+#include <ropufu/noexcept_json.hpp>
+
+#include "memory_mapped_file.hpp"
+
+#include <atomic>      // std::atomic_size_t, std::memory_order_relaxed
+#include <concepts>    // std::floating_point
+#include <cstddef>     // std::size_t, std::byte
+#include <cstdint>     // std::uint32_t, std::uint64_t
+#include <cstring>     // std::memcmp, std::memcpy
+#include <filesystem>  // std::filesystem::path
+#include <optional>    // std::optional, std::nullopt
+#include <span>        // std::span
+#include <stdexcept>   // std::logic_error, std::runtime_error
+#include <string>      // std::string
+#include <string_view> // std::string_view
+
+namespace ropufu::sequential::gaussian_mean_hypotheses
+{
+    struct noise_trace_settings;
+
+    void to_json(nlohmann::json& j, const noise_trace_settings& x) noexcept;
+    void from_json(const nlohmann::json& j, noise_trace_settings& x);
+
+    enum struct noise_trace_mode : char
+    {
+        none = 0,
+        record = 1,
+        replay = 2
+    }; // enum struct noise_trace_mode
+
+    /** Describes where, and whether, the simulated noise should be recorded to or replayed from. */
+    struct noise_trace_settings
+    {
+        using type = noise_trace_settings;
+
+        // ~~ Json names ~~
+        static constexpr std::string_view jstr_path = "path";
+        static constexpr std::string_view jstr_mode = "mode";
+        static constexpr std::string_view jstr_samples_per_path = "samples per path";
+
+        static constexpr std::string_view jstr_record = "record";
+        static constexpr std::string_view jstr_replay = "replay";
+
+        friend ropufu::noexcept_json_serializer<type>;
+
+    private:
+        std::filesystem::path m_path = {};
+        noise_trace_mode m_mode = noise_trace_mode::none;
+        std::size_t m_samples_per_path = 1'000;
+
+        /** @brief Validates the structure and returns an error message, if any. */
+        std::optional<std::string> error_message() const noexcept
+        {
+            if (this->m_mode == noise_trace_mode::none) return std::nullopt;
+            if (this->m_path.empty()) return "Noise trace path must not be empty.";
+            if (this->m_samples_per_path == 0) return "Samples per path must be positive.";
+
+            return std::nullopt;
+        } // error_message(...)
+
+    public:
+        noise_trace_settings() noexcept = default;
+
+        bool empty() const noexcept { return this->m_mode == noise_trace_mode::none; }
+
+        const std::filesystem::path& path() const noexcept { return this->m_path; }
+
+        noise_trace_mode mode() const noexcept { return this->m_mode; }
+
+        std::size_t samples_per_path() const noexcept { return this->m_samples_per_path; }
+
+        friend void to_json(nlohmann::json& j, const type& x) noexcept
+        {
+            j = nlohmann::json{
+                {type::jstr_path, x.m_path.string()},
+                {type::jstr_mode, x.m_mode == noise_trace_mode::record ? type::jstr_record : type::jstr_replay},
+                {type::jstr_samples_per_path, x.m_samples_per_path}
+            };
+        } // to_json(...)
+
+        friend void from_json(const nlohmann::json& j, type& x)
+        {
+            if (!ropufu::noexcept_json::try_get(j, x))
+                throw std::runtime_error("Parsing <noise_trace_settings> failed: " + j.dump());
+        } // from_json(...)
+    }; // struct noise_trace_settings
+
+    /** @brief Memory-mapped storage of noise sequences, one fixed-capacity slot per simulated path.
+     *  @details Layout: header, followed by the recorded length of every path, followed by
+     *  the slots themselves (aligned to cache lines).
+     */
+    template <std::floating_point t_value_type>
+    struct noise_trace
+    {
+        using type = noise_trace<t_value_type>;
+        using value_type = t_value_type;
+
+        static constexpr std::uint32_t version = 2;
+        static constexpr std::size_t alignment = 64;
+
+        struct header_type
+        {
+            char signature[8];
+            std::uint32_t version;
+            std::uint32_t value_size;
+            std::uint64_t count_paths;
+            std::uint64_t samples_per_path;
+            std::uint64_t count_channels;
+        }; // struct header_type
+
+    private:
+        static constexpr char signature[8] = {'G', 'M', 'H', 'N', 'O', 'I', 'S', 'E'};
+
+        memory_mapped_file m_file = {};
+        std::size_t m_count_paths = 0;
+        std::size_t m_samples_per_path = 0;
+        std::size_t m_count_channels = 1;
+        std::uint64_t* m_lengths = nullptr;
+        value_type* m_samples = nullptr;
+        std::atomic_size_t m_next_path = 0;
+
+        static std::size_t samples_offset(std::size_t count_paths) noexcept
+        {
+            std::size_t offset = sizeof(header_type) + count_paths * sizeof(std::uint64_t);
+            return ((offset + type::alignment - 1) / type::alignment) * type::alignment;
+        } // samples_offset(...)
+
+        void attach() noexcept
+        {
+            std::byte* data = this->m_file.data();
+            this->m_lengths = reinterpret_cast<std::uint64_t*>(data + sizeof(header_type));
+            this->m_samples = reinterpret_cast<value_type*>(data + type::samples_offset(this->m_count_paths));
+        } // attach(...)
+
+    public:
+        /** Creates a new trace file with room for \p count_paths paths of a model with \p count_channels channels.
+         *  @exception std::runtime_error Mapping failed.
+         */
+        noise_trace(const std::filesystem::path& path, std::size_t count_paths, std::size_t samples_per_path, std::size_t count_channels)
+            : m_file(path, type::samples_offset(count_paths) + count_paths * samples_per_path * sizeof(value_type)),
+            m_count_paths(count_paths), m_samples_per_path(samples_per_path), m_count_channels(count_channels)
+        {
+            header_type header{};
+            std::memcpy(header.signature, type::signature, sizeof(type::signature));
+            header.version = type::version;
+            header.value_size = static_cast<std::uint32_t>(sizeof(value_type));
+            header.count_paths = count_paths;
+            header.samples_per_path = samples_per_path;
+            header.count_channels = count_channels;
+            std::memcpy(this->m_file.data(), &header, sizeof(header_type));
+
+            this->attach();
+            for (std::size_t i = 0; i < count_paths; ++i) this->m_lengths[i] = 0;
+        } // noise_trace(...)
+
+        /** @brief Opens an existing trace file to be replayed into a model with \p count_channels channels.
+         *  @details Noise recorded for a different number of channels would be regrouped into other rows,
+         *  losing the pairing of common random numbers.
+         *  @exception std::runtime_error Mapping failed, or the file is not a compatible trace.
+         */
+        noise_trace(const std::filesystem::path& path, std::size_t count_channels)
+            : m_file(path), m_count_channels(count_channels)
+        {
+            if (this->m_file.size() < sizeof(header_type)) throw std::runtime_error("Noise trace " + path.string() + " is truncated.");
+
+            header_type header{};
+            std::memcpy(&header, this->m_file.data(), sizeof(header_type));
+            if (std::memcmp(header.signature, type::signature, sizeof(type::signature)) != 0) throw std::runtime_error(path.string() + " is not a noise trace.");
+            if (header.version != type::version) throw std::runtime_error("Noise trace " + path.string() + " has unsupported version.");
+            if (header.value_size != sizeof(value_type)) throw std::runtime_error("Noise trace " + path.string() + " has mismatched value type.");
+            if (header.count_channels != count_channels) throw std::runtime_error("Noise trace " + path.string() + " has mismatched number of channels.");
+
+            this->m_count_paths = static_cast<std::size_t>(header.count_paths);
+            this->m_samples_per_path = static_cast<std::size_t>(header.samples_per_path);
+            std::size_t expected_size = type::samples_offset(this->m_count_paths) + this->m_count_paths * this->m_samples_per_path * sizeof(value_type);
+            if (this->m_file.size() < expected_size) throw std::runtime_error("Noise trace " + path.string() + " is truncated.");
+
+            this->attach();
+        } // noise_trace(...)
+
+        noise_trace(const type&) = delete;
+        type& operator =(const type&) = delete;
+
+        std::size_t count_paths() const noexcept { return this->m_count_paths; }
+
+        std::size_t samples_per_path() const noexcept { return this->m_samples_per_path; }
+
+        std::size_t count_channels() const noexcept { return this->m_count_channels; }
+
+        /** Restarts path assignment from the first slot. */
+        void rewind() noexcept
+        {
+            this->m_next_path.store(0, std::memory_order_relaxed);
+        } // rewind(...)
+
+        /** Assigns the next path index; safe to call from several threads. */
+        std::size_t claim() noexcept
+        {
+            return this->m_next_path.fetch_add(1, std::memory_order_relaxed);
+        } // claim(...)
+
+        /** Writable storage for path \p index. */
+        std::span<value_type> slot(std::size_t index) noexcept
+        {
+            return {this->m_samples + index * this->m_samples_per_path, this->m_samples_per_path};
+        } // slot(...)
+
+        /** Recorded noise of path \p index. */
+        std::span<const value_type> recorded(std::size_t index) const noexcept
+        {
+            return {this->m_samples + index * this->m_samples_per_path, static_cast<std::size_t>(this->m_lengths[index])};
+        } // recorded(...)
+
+        /** Marks the first \p length samples of path \p index as recorded. */
+        void commit(std::size_t index, std::size_t length) noexcept
+        {
+            this->m_lengths[index] = length;
+        } // commit(...)
+
+        void flush() noexcept
+        {
+            this->m_file.flush();
+        } // flush(...)
+    }; // struct noise_trace
+} // namespace ropufu::sequential::gaussian_mean_hypotheses
+
+namespace ropufu
+{
+    template <>
+    struct noexcept_json_serializer<ropufu::sequential::gaussian_mean_hypotheses::noise_trace_settings>
+    {
+        using result_type = ropufu::sequential::gaussian_mean_hypotheses::noise_trace_settings;
+        static bool try_get(const nlohmann::json& j, result_type& x) noexcept
+        {
+            std::string path;
+            std::string mode_name;
+            if (!noexcept_json::required(j, result_type::jstr_path, path)) return false;
+            if (!noexcept_json::required(j, result_type::jstr_mode, mode_name)) return false;
+            if (!noexcept_json::optional(j, result_type::jstr_samples_per_path, x.m_samples_per_path)) return false;
+
+            if (mode_name == result_type::jstr_record) x.m_mode = ropufu::sequential::gaussian_mean_hypotheses::noise_trace_mode::record;
+            else if (mode_name == result_type::jstr_replay) x.m_mode = ropufu::sequential::gaussian_mean_hypotheses::noise_trace_mode::replay;
+            else return false;
+
+            x.m_path = path;
+            if (x.error_message().has_value()) return false;
+
+            return true;
+        } // try_get(...)
+    }; // struct noexcept_json_serializer<...>
+} // namespace ropufu
+
+#endif // ROPUFU_SEQUENTIAL_GAUSSIAN_MEAN_HYPOTHESES_NOISE_TRACE_HPP_INCLUDED
@@ -0,0 +1,138 @@
+
+#ifndef ROPUFU_SEQUENTIAL_GAUSSIAN_MEAN_HYPOTHESES_PINNED_MONTE_CARLO_HPP_INCLUDED
+#define ROPUFU_SEQUENTIAL_GAUSSIAN_MEAN_HYPOTHESES_PINNED_MONTE_CARLO_HPP_INCLUDED
+
+#include "thread_affinity.hpp"
+
+#include <atomic>      // std::atomic_size_t, std::memory_order_relaxed
+#include <barrier>     // std::barrier
+#include <chrono>      // std::chrono::steady_clock, std::chrono::nanoseconds
+#include <concepts>    // std::invocable, std::convertible_to
+#include <cstddef>     // std::size_t, std::ptrdiff_t
+#include <thread>      // std::thread
+#include <type_traits> // std::invoke_result_t
+#include <utility>     // std::move
+#include <vector>      // std::vector
+
+namespace ropufu::sequential::gaussian_mean_hypotheses
+{
+    /** Aggregators that can be merged in independent parts, concurrently. */
+    template <typename t_aggregator_type>
+    concept part_mergeable = requires(t_aggregator_type& x, const t_aggregator_type& y, std::size_t part)
+    {
+        { t_aggregator_type::count_merge_parts } -> std::convertible_to<std::size_t>;
+        x.prepare_merge(y);
+        x.merge_part(y, part);
+    }; // concept part_mergeable
+
+    /** @brief Runs simulations on worker threads that own all of their state.
+     *  @details Every worker optionally pins itself to a core, then constructs its simulator and aggregator on its own stack,
+     *  so that every buffer they allocate is first touched, and hence placed, on the worker's NUMA node.
+     *  Per-worker results are kept in cache-line-aligned slots and merged into the first one once all workers have finished.
+     *  Aggregators that can be merged part by part are reduced by all workers together: each worker claims parts and folds
+     *  that part of every other slot into the first, in worker order, so the result is identical to a serial merge.
+     */
+    template <typename t_simulator_type, typename t_aggregator_type>
+    struct pinned_monte_carlo
+    {
+        using type = pinned_monte_carlo<t_simulator_type, t_aggregator_type>;
+        using simulator_type = t_simulator_type;
+        using aggregator_type = t_aggregator_type;
+
+    private:
+        /** Results of a single worker, padded to whole cache lines to keep workers from sharing them. */
+        struct alignas(64) worker_slot
+        {
+            aggregator_type result = {};
+            bool is_pinned = false;
+        }; // struct worker_slot
+
+        std::size_t m_count_threads = 1;
+        bool m_is_pinning = true;
+        std::size_t m_count_pinned = 0;
+        std::chrono::nanoseconds m_reduction_duration = {};
+
+    public:
+        pinned_monte_carlo() noexcept = default;
+
+        /** @param is_pinning If false, workers still own their state but are left to the scheduler. */
+        pinned_monte_carlo(std::size_t count_threads, bool is_pinning) noexcept
+            : m_count_threads(count_threads == 0 ? 1 : count_threads), m_is_pinning(is_pinning)
+        {
+        } // pinned_monte_carlo(...)
+
+        std::size_t count_threads() const noexcept { return this->m_count_threads; }
+
+        /** Number of workers that were pinned during the last execution. */
+        std::size_t count_pinned() const noexcept { return this->m_count_pinned; }
+
+        /** Time spent merging per-worker results during the last execution. */
+        std::chrono::nanoseconds reduction_duration() const noexcept { return this->m_reduction_duration; }
+
+        /** @brief Runs \p count_simulations simulations split evenly across the workers.
+         *  @param make_simulator Called on each worker thread with the worker's index; returns the worker's simulator, seeded.
+         */
+        template <std::invocable<std::size_t> t_factory_type>
+            requires std::same_as<std::invoke_result_t<t_factory_type, std::size_t>, simulator_type>
+        aggregator_type execute_sync(std::size_t count_simulations, t_factory_type&& make_simulator)
+        {
+            std::size_t count_workers = this->m_count_threads;
+            if (count_workers > count_simulations) count_workers = count_simulations;
+            if (count_workers == 0) return {};
+
+            using clock_type = std::chrono::steady_clock;
+
+            std::vector<worker_slot> slots(count_workers);
+            std::vector<std::thread> workers{};
+            workers.reserve(count_workers);
+
+            // Runs once every worker has stored its result.
+            clock_type::time_point reduction_start{};
+            std::atomic_size_t next_part = 0;
+            auto on_simulated = [&slots, &reduction_start] () noexcept {
+                reduction_start = clock_type::now();
+                if constexpr (part_mergeable<aggregator_type>)
+                {
+                    for (std::size_t i = 1; i < slots.size(); ++i) slots.front().result.prepare_merge(slots[i].result);
+                } // if constexpr (...)
+            };
+            std::barrier<decltype(on_simulated)> simulated{static_cast<std::ptrdiff_t>(count_workers), on_simulated};
+
+            for (std::size_t i = 0; i < count_workers; ++i)
+            {
+                std::size_t count_local = count_simulations / count_workers + (i < count_simulations % count_workers ? 1 : 0);
+                workers.emplace_back([this, i, count_local, &slots, &make_simulator, &simulated, &next_part] () {
+                    if (this->m_is_pinning) slots[i].is_pinned = pin_current_thread(i);
+                    simulator_type simulator = make_simulator(i);
+                    aggregator_type local{};
+                    for (std::size_t k = 0; k < count_local; ++k) local(simulator());
+                    slots[i].result = std::move(local);
+
+                    simulated.arrive_and_wait();
+                    if constexpr (part_mergeable<aggregator_type>)
+                    {
+                        // Claim parts one at a time; each part is folded over all slots in worker order.
+                        for (std::size_t part = next_part.fetch_add(1, std::memory_order_relaxed); part < aggregator_type::count_merge_parts;
+                            part = next_part.fetch_add(1, std::memory_order_relaxed))
+                        {
+                            for (std::size_t k = 1; k < slots.size(); ++k) slots.front().result.merge_part(slots[k].result, part);
+                        } // for (...)
+                    } // if constexpr (...)
+                });
+            } // for (...)
+            for (std::thread& x : workers) x.join();
+
+            if constexpr (!part_mergeable<aggregator_type>)
+            {
+                for (std::size_t i = 1; i < count_workers; ++i) slots.front().result(slots[i].result);
+            } // if constexpr (...)
+            this->m_reduction_duration = clock_type::now() - reduction_start;
+
+            this->m_count_pinned = 0;
+            for (const worker_slot& x : slots) if (x.is_pinned) ++this->m_count_pinned;
+            return std::move(slots.front().result);
+        } // execute_sync(...)
+    }; // struct pinned_monte_carlo
+} // namespace ropufu::sequential::gaussian_mean_hypotheses
+
+#endif // ROPUFU_SEQUENTIAL_GAUSSIAN_MEAN_HYPOTHESES_PINNED_MONTE_CARLO_HPP_INCLUDED
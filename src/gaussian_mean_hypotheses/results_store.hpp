@@ -0,0 +1,208 @@
+
+#ifndef ROPUFU_SEQUENTIAL_GAUSSIAN_MEAN_HYPOTHESES_RESULTS_STORE_HPP_INCLUDED
+#define ROPUFU_SEQUENTIAL_GAUSSIAN_MEAN_HYPOTHESES_RESULTS_STORE_HPP_INCLUDED
+
+#include <nlohmann/json.hpp>
+#include <ropufu/noexcept_json.hpp>
+
+#include "binary_archive.hpp"
+#include "fingerprint.hpp"
+
+#include <cstddef>      // std::size_t
+#include <cstdint>      // std::uint32_t
+#include <cstring>      // std::memcmp, std::memcpy
+#include <filesystem>   // std::filesystem::path, std::filesystem::create_directories, std::filesystem::rename
+#include <fstream>      // std::ifstream, std::ofstream
+#include <ios>          // std::ios_base
+#include <stdexcept>    // std::runtime_error
+#include <string>       // std::string
+#include <string_view>  // std::string_view
+#include <system_error> // std::error_code
+#include <utility>      // std::move
+
+namespace ropufu::sequential::gaussian_mean_hypotheses
+{
+    struct results_store_settings;
+
+    void to_json(nlohmann::json& j, const results_store_settings& x) noexcept;
+    void from_json(const nlohmann::json& j, results_store_settings& x);
+
+    /** Describes where, and whether, simulation results should be kept between runs. */
+    struct results_store_settings
+    {
+        using type = results_store_settings;
+
+        // ~~ Json names ~~
+        static constexpr std::string_view jstr_directory = "directory";
+
+        friend ropufu::noexcept_json_serializer<type>;
+
+    private:
+        std::filesystem::path m_directory = {};
+
+    public:
+        results_store_settings() noexcept = default;
+
+        /** Results are not kept. */
+        bool empty() const noexcept { return this->m_directory.empty(); }
+
+        const std::filesystem::path& directory() const noexcept { return this->m_directory; }
+
+        friend void to_json(nlohmann::json& j, const type& x) noexcept
+        {
+            j = nlohmann::json{
+                {type::jstr_directory, x.m_directory.string()}
+            };
+        } // to_json(...)
+
+        friend void from_json(const nlohmann::json& j, type& x)
+        {
+            if (!ropufu::noexcept_json::try_get(j, x))
+                throw std::runtime_error("Parsing <results_store_settings> failed: " + j.dump());
+        } // from_json(...)
+    }; // struct results_store_settings
+
+    enum struct results_lookup : char
+    {
+        /** Nothing has been stored under the key. */
+        missing = 0,
+        found = 1,
+        /** A file is in the place of the key, but it was written for a different key or by an incompatible version. */
+        mismatched = 2
+    }; // enum struct results_lookup
+
+    /** @brief Aggregated results of earlier runs, addressed by the configuration they were simulated for.
+     *  @details Every key is a canonical description of what has been simulated; the file name is derived from its hash.
+     *  The key itself is stored alongside the results and compared in full on every lookup,
+     *  so that colliding hashes and files written by other versions are never mistaken for a match.
+     *  Layout: header, the key, then the aggregator.
+     *  @tparam t_aggregator_type Has to provide \c write(binary_writer&) and \c read(binary_reader&).
+     */
+    template <typename t_aggregator_type>
+    struct results_store
+    {
+        using type = results_store<t_aggregator_type>;
+        using aggregator_type = t_aggregator_type;
+
+        /** Revision of the file layout; what the results mean is up to the key. */
+        static constexpr std::uint32_t version = 1;
+
+        struct header_type
+        {
+            char signature[8];
+            std::uint32_t version;
+            std::uint32_t size_size;
+        }; // struct header_type
+
+    private:
+        static constexpr char signature[8] = {'G', 'M', 'H', 'R', 'S', 'L', 'T', 'S'};
+
+        std::filesystem::path m_directory = {};
+
+    public:
+        explicit results_store(const results_store_settings& settings) noexcept
+            : m_directory(settings.directory())
+        {
+        } // results_store(...)
+
+        /** File the results for \p key are kept in. */
+        std::filesystem::path path_of(std::string_view key) const noexcept
+        {
+            fingerprint hash{};
+            hash.add(key);
+            return this->m_directory / (hash.to_string() + ".gmhr");
+        } // path_of(...)
+
+        /** @brief Loads the results stored for \p key into \p result.
+         *  @details \p result is only modified if the lookup is \c results_lookup::found.
+         *  @exception std::runtime_error The file matches \p key but cannot be read.
+         */
+        results_lookup try_load(const std::string& key, aggregator_type& result) const
+        {
+            std::filesystem::path path = this->path_of(key);
+            std::ifstream filestream{path, std::ios_base::binary};
+            if (filestream.fail()) return results_lookup::missing;
+
+            binary_reader reader{filestream};
+            header_type header{};
+            std::string stored_key{};
+            try
+            {
+                reader.read(header);
+                if (std::memcmp(header.signature, type::signature, sizeof(type::signature)) != 0) return results_lookup::mismatched;
+                if (header.version != type::version || header.size_size != sizeof(std::size_t)) return results_lookup::mismatched;
+                reader.read_string(stored_key);
+            } // try
+            catch (const std::runtime_error&)
+            {
+                return results_lookup::mismatched;
+            } // catch (...)
+            if (stored_key != key) return results_lookup::mismatched;
+
+            aggregator_type stored{};
+            try
+            {
+                stored.read(reader);
+            } // try
+            catch (const std::runtime_error& e)
+            {
+                throw std::runtime_error("Stored results " + path.string() + " are corrupted: " + e.what());
+            } // catch (...)
+            result = std::move(stored);
+            return results_lookup::found;
+        } // try_load(...)
+
+        /** @brief Stores \p results under \p key, replacing whatever was there.
+         *  @details Results are written to a temporary file first, so an interrupted run never leaves a partial file behind.
+         *  @exception std::runtime_error Writing failed.
+         */
+        void store(const std::string& key, const aggregator_type& results) const
+        {
+            std::error_code error{};
+            if (!this->m_directory.empty()) std::filesystem::create_directories(this->m_directory, error);
+            if (error) throw std::runtime_error("Failed to create " + this->m_directory.string() + ": " + error.message());
+
+            std::filesystem::path path = this->path_of(key);
+            std::filesystem::path temporary_path = path;
+            temporary_path += ".tmp";
+            {
+                std::ofstream filestream{temporary_path, std::ios_base::binary | std::ios_base::trunc};
+                if (filestream.fail()) throw std::runtime_error("Failed to open " + temporary_path.string() + " for writing.");
+
+                header_type header{};
+                std::memcpy(header.signature, type::signature, sizeof(type::signature));
+                header.version = type::version;
+                header.size_size = static_cast<std::uint32_t>(sizeof(std::size_t));
+
+                binary_writer writer{filestream};
+                writer.write(header);
+                writer.write_string(key);
+                results.write(writer);
+                filestream.flush();
+                if (!writer.good()) throw std::runtime_error("Failed to write " + temporary_path.string() + ".");
+            } // ofstream
+            std::filesystem::rename(temporary_path, path, error);
+            if (error) throw std::runtime_error("Failed to replace " + path.string() + ": " + error.message());
+        } // store(...)
+    }; // struct results_store
+} // namespace ropufu::sequential::gaussian_mean_hypotheses
+
+namespace ropufu
+{
+    template <>
+    struct noexcept_json_serializer<ropufu::sequential::gaussian_mean_hypotheses::results_store_settings>
+    {
+        using result_type = ropufu::sequential::gaussian_mean_hypotheses::results_store_settings;
+        static bool try_get(const nlohmann::json& j, result_type& x) noexcept
+        {
+            std::string directory;
+            if (!noexcept_json::required(j, result_type::jstr_directory, directory)) return false;
+            if (directory.empty()) return false;
+
+            x.m_directory = directory;
+            return true;
+        } // try_get(...)
+    }; // struct noexcept_json_serializer<...>
+} // namespace ropufu
+
+#endif // ROPUFU_SEQUENTIAL_GAUSSIAN_MEAN_HYPOTHESES_RESULTS_STORE_HPP_INCLUDED
@@ -0,0 +1,118 @@
+
+#ifndef ROPUFU_SEQUENTIAL_GAUSSIAN_MEAN_HYPOTHESES_RULES_HPP_INCLUDED
+#define ROPUFU_SEQUENTIAL_GAUSSIAN_MEAN_HYPOTHESES_RULES_HPP_INCLUDED
+
+#include "xsprt.hpp"
+
+#include <cmath>       // std::log
+#include <concepts>    // std::floating_point
+#include <string_view> // std::string_view
+#include <utility>     // std::pair, std::make_pair
+
+namespace ropufu::sequential::gaussian_mean_hypotheses
+{
+    /** CUSUM-style test: two reflected random walks of the SPRT increments between zero and the weakest signal strength. */
+    template <std::floating_point t_value_type>
+    struct cusum_rule
+    {
+        using type = cusum_rule<t_value_type>;
+        using value_type = t_value_type;
+        using context_type = xsprt_context<value_type>;
+
+        /** Names the rule. */
+        static constexpr std::string_view name = "CUSUM";
+        /** Spells out the fixed parameters of the rule. */
+        static constexpr std::string_view parameters = "increments of the SPRT between zero and the weakest signal strength, reflected at zero";
+
+    private:
+        value_type m_against_alternative = 0;
+        value_type m_against_null = 0;
+
+    public:
+        void reset() noexcept
+        {
+            this->m_against_alternative = 0;
+            this->m_against_null = 0;
+        } // reset(...)
+
+        std::pair<value_type, value_type> statistic(const context_type& context) noexcept
+        {
+            value_type mu = context.weakest_signal_strength;
+            value_type increment = mu * (context.signal_times_observation - mu * context.signal_squared / 2);
+
+            this->m_against_alternative -= increment;
+            this->m_against_null += increment;
+            if (this->m_against_alternative < 0) this->m_against_alternative = 0;
+            if (this->m_against_null < 0) this->m_against_null = 0;
+
+            return std::make_pair(this->m_against_alternative, this->m_against_null);
+        } // statistic(...)
+    }; // struct cusum_rule
+
+    /** @brief Mixture SPRT: the alternative likelihood is averaged over a Gaussian prior on the signal strength.
+     *  @details The prior is centered at the weakest signal strength, with standard deviation equal to it.
+     *  The null is accepted on the log-likelihood ratio against the weakest signal strength:
+     *  under the null the negated mixture statistic only grows like the logarithm of the sample size, and would rarely cross a threshold.
+     */
+    template <std::floating_point t_value_type>
+    struct mixture_sprt_rule
+    {
+        using type = mixture_sprt_rule<t_value_type>;
+        using value_type = t_value_type;
+        using context_type = xsprt_context<value_type>;
+
+        /** Names the rule. */
+        static constexpr std::string_view name = "mSPRT";
+        /** Spells out the fixed parameters of the rule. */
+        static constexpr std::string_view parameters = "Gaussian prior with mean and standard deviation equal to the weakest signal strength; accepts the null on the SPRT against the weakest signal strength";
+
+        void reset() noexcept
+        {
+        } // reset(...)
+
+        std::pair<value_type, value_type> statistic(const context_type& context) noexcept
+        {
+            const xsprt_state<value_type>& state = context.state;
+            value_type m = context.weakest_signal_strength;
+            value_type inverse_v = 1 / (m * m);
+
+            value_type x = state.running_sum_of_signal_times_observation + m * inverse_v;
+            value_type precision = state.running_sum_of_signal_squared + inverse_v;
+            value_type log_mixture_likelihood_ratio =
+                (x * x / precision - m * m * inverse_v - std::log(precision / inverse_v)) / 2;
+
+            return std::make_pair(state.log_likelihood_ratio_between(0, m), log_mixture_likelihood_ratio);
+        } // statistic(...)
+    }; // struct mixture_sprt_rule
+
+    /** Lorden's 2-SPRT, with the intermediate point half way between zero and the weakest signal strength. */
+    template <std::floating_point t_value_type>
+    struct two_sprt_rule
+    {
+        using type = two_sprt_rule<t_value_type>;
+        using value_type = t_value_type;
+        using context_type = xsprt_context<value_type>;
+
+        /** Names the rule. */
+        static constexpr std::string_view name = "2-SPRT";
+        /** Spells out the fixed parameters of the rule. */
+        static constexpr std::string_view parameters = "intermediate point at half the weakest signal strength";
+
+        void reset() noexcept
+        {
+        } // reset(...)
+
+        std::pair<value_type, value_type> statistic(const context_type& context) noexcept
+        {
+            const xsprt_state<value_type>& state = context.state;
+            value_type mu = context.weakest_signal_strength;
+            value_type intermediate = mu / 2;
+
+            return std::make_pair(
+                state.log_likelihood_ratio_between(intermediate, mu),
+                state.log_likelihood_ratio_between(intermediate, 0));
+        } // statistic(...)
+    }; // struct two_sprt_rule
+} // namespace ropufu::sequential::gaussian_mean_hypotheses
+
+#endif // ROPUFU_SEQUENTIAL_GAUSSIAN_MEAN_HYPOTHESES_RULES_HPP_INCLUDED
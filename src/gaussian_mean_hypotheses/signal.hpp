@@ -0,0 +1,455 @@
+
+#ifndef ROPUFU_SEQUENTIAL_GAUSSIAN_MEAN_HYPOTHESES_SIGNAL_HPP_INCLUDED
+#define ROPUFU_SEQUENTIAL_GAUSSIAN_MEAN_HYPOTHESES_SIGNAL_HPP_INCLUDED
+
+#include <nlohmann/json.hpp>
+#include <ropufu/noexcept_json.hpp>
+
+#include <ropufu/number_traits.hpp>
+
+#include "fingerprint.hpp"
+
+#include <array>       // std::array
+#include <cmath>       // std::sin
+#include <concepts>    // std::floating_point
+#include <cstddef>     // std::size_t
+#include <filesystem>  // std::filesystem::path
+#include <fstream>     // std::ifstream
+#include <functional>  // std::hash
+#include <limits>      // std::numeric_limits
+#include <new>         // std::align_val_t, std::bad_alloc
+#include <numbers>     // std::numbers::pi_v
+#include <optional>    // std::optional, std::nullopt
+#include <stdexcept>   // std::logic_error, std::runtime_error
+#include <string>      // std::string
+#include <string_view> // std::string_view
+#include <vector>      // std::vector
+
+#ifdef ROPUFU_TMP_TYPENAME
+#undef ROPUFU_TMP_TYPENAME
+#endif
+#ifdef ROPUFU_TMP_TEMPLATE_SIGNATURE
+#undef ROPUFU_TMP_TEMPLATE_SIGNATURE
+#endif
+#define ROPUFU_TMP_TYPENAME tabulated_signal<t_value_type>
+#define ROPUFU_TMP_TEMPLATE_SIGNATURE template <std::floating_point t_value_type>
+
+namespace ropufu::sequential::gaussian_mean_hypotheses
+{
+    namespace detail
+    {
+        /** Allocator aligning storage to cache lines. */
+        template <typename t_data_type, std::size_t t_alignment = 64>
+        struct cache_aligned_allocator
+        {
+            using value_type = t_data_type;
+
+            template <typename t_other_type>
+            struct rebind { using other = cache_aligned_allocator<t_other_type, t_alignment>; };
+
+            cache_aligned_allocator() noexcept = default;
+
+            template <typename t_other_type>
+            cache_aligned_allocator(const cache_aligned_allocator<t_other_type, t_alignment>& /*other*/) noexcept { }
+
+            t_data_type* allocate(std::size_t n)
+            {
+                if (n > std::numeric_limits<std::size_t>::max() / sizeof(t_data_type)) throw std::bad_alloc();
+                return static_cast<t_data_type*>(::operator new(n * sizeof(t_data_type), std::align_val_t{t_alignment}));
+            } // allocate(...)
+
+            void deallocate(t_data_type* p, std::size_t /*n*/) noexcept
+            {
+                ::operator delete(p, std::align_val_t{t_alignment});
+            } // deallocate(...)
+
+            template <typename t_other_type>
+            bool operator ==(const cache_aligned_allocator<t_other_type, t_alignment>& /*other*/) const noexcept { return true; }
+        }; // struct cache_aligned_allocator
+    } // namespace detail
+
+    /** Signal value and cumulative sum of squared signal values, stored side by side. */
+    template <std::floating_point t_value_type>
+    struct signal_entry
+    {
+        t_value_type value;
+        t_value_type cumulative_squared;
+    }; // struct signal_entry
+
+    /** @brief Position of an observation within a periodic signal.
+     *  @details Signals advance it one observation at a time, so lookups past the first period need no division.
+     */
+    struct signal_phase
+    {
+        /** Number of whole periods before the observation. */
+        std::size_t count_periods = 0;
+        /** Zero-based index of the observation within its period. */
+        std::size_t index = 0;
+
+        /** Moves to the next observation of a signal with period \p period. */
+        constexpr void advance(std::size_t period) noexcept
+        {
+            if (++this->index != period) return;
+            this->index = 0;
+            ++this->count_periods;
+        } // advance(...)
+    }; // struct signal_phase
+
+    /** Signal identically equal to one. */
+    template <std::floating_point t_value_type>
+    struct constant_signal
+    {
+        using value_type = t_value_type;
+
+        /** Signal at time \p time >= 1. */
+        constexpr value_type at(std::size_t /*time*/) const noexcept { return 1; }
+
+        /** Signal at \p phase. */
+        constexpr value_type at(const signal_phase& /*phase*/) const noexcept { return 1; }
+
+        /** Sum of squared signal values up to and including \p phase. */
+        constexpr value_type cumulative_squared(const signal_phase& phase) const noexcept { return static_cast<value_type>(phase.count_periods + 1); }
+
+        constexpr void advance(signal_phase& phase) const noexcept { phase.advance(1); }
+    }; // struct constant_signal
+
+    /** Periodic signal alternating between one and minus one, starting with one. */
+    struct alternating_shape
+    {
+        static constexpr std::size_t period = 2;
+
+        template <std::floating_point t_value_type>
+        constexpr t_value_type operator ()(std::size_t index) const noexcept { return (index % 2 == 0) ? 1 : -1; }
+    }; // struct alternating_shape
+
+    /** @brief Periodic signal with a table generated at compile time.
+     *  @tparam t_shape_type Provides \c period and a constexpr call operator mapping zero-based index within the period to the signal value.
+     */
+    template <std::floating_point t_value_type, typename t_shape_type>
+    struct constexpr_signal
+    {
+        using value_type = t_value_type;
+        using entry_type = signal_entry<value_type>;
+
+        static constexpr std::size_t period = t_shape_type::period;
+
+    private:
+        static constexpr std::array<entry_type, period> make_table() noexcept
+        {
+            std::array<entry_type, period> result{};
+            t_shape_type shape{};
+            value_type sum = 0;
+            for (std::size_t k = 0; k < period; ++k)
+            {
+                value_type x = shape.template operator ()<value_type>(k);
+                sum += x * x;
+                result[k] = {x, sum};
+            } // for (...)
+            return result;
+        } // make_table(...)
+
+        alignas(64) static constexpr std::array<entry_type, period> table = make_table();
+
+    public:
+        constexpr value_type at(std::size_t time) const noexcept { return table[(time - 1) % period].value; }
+
+        constexpr value_type at(const signal_phase& phase) const noexcept { return table[phase.index].value; }
+
+        constexpr value_type cumulative_squared(const signal_phase& phase) const noexcept
+        {
+            return static_cast<value_type>(phase.count_periods) * table[period - 1].cumulative_squared + table[phase.index].cumulative_squared;
+        } // cumulative_squared(...)
+
+        constexpr void advance(signal_phase& phase) const noexcept { phase.advance(period); }
+    }; // struct constexpr_signal
+
+    ROPUFU_TMP_TEMPLATE_SIGNATURE
+    struct tabulated_signal;
+
+    ROPUFU_TMP_TEMPLATE_SIGNATURE
+    void to_json(nlohmann::json& j, const ROPUFU_TMP_TYPENAME& x) noexcept;
+    ROPUFU_TMP_TEMPLATE_SIGNATURE
+    void from_json(const nlohmann::json& j, ROPUFU_TMP_TYPENAME& x);
+
+    enum struct signal_shape : char
+    {
+        constant = 0,
+        alternating = 1,
+        periodic = 2,
+        chirp = 3,
+        file = 4
+    }; // enum struct signal_shape
+
+    /** @brief Known deterministic signal S_n, n >= 1.
+     *  @details Every shape is evaluated once into a cache-aligned table holding one period of the signal
+     *  along with the cumulative sums of squared values. Shapes without a natural period (chirp, file) would repeat
+     *  their table past its end, so paths must not outlast it; see \c is_periodic.
+     */
+    ROPUFU_TMP_TEMPLATE_SIGNATURE
+    struct tabulated_signal
+    {
+        using type = ROPUFU_TMP_TYPENAME;
+        using value_type = t_value_type;
+        using entry_type = signal_entry<value_type>;
+        using table_type = std::vector<entry_type, detail::cache_aligned_allocator<entry_type>>;
+
+        // ~~ Json names ~~
+        static constexpr std::string_view jstr_type = "type";
+        static constexpr std::string_view jstr_values = "values";
+        static constexpr std::string_view jstr_length = "length";
+        static constexpr std::string_view jstr_amplitude = "amplitude";
+        static constexpr std::string_view jstr_start_frequency = "start frequency";
+        static constexpr std::string_view jstr_end_frequency = "end frequency";
+        static constexpr std::string_view jstr_path = "path";
+
+        static constexpr std::array<std::string_view, 5> shape_names = {"constant", "alternating", "periodic", "chirp", "file"};
+
+        friend ropufu::noexcept_json_serializer<type>;
+        friend std::hash<type>;
+
+    private:
+        signal_shape m_shape = signal_shape::constant;
+        std::vector<value_type> m_values = {}; // Periodic shape.
+        std::size_t m_length = 0; // Chirp shape.
+        value_type m_amplitude = 1; // Chirp shape.
+        value_type m_start_frequency = 0; // Chirp shape, in cycles per observation.
+        value_type m_end_frequency = 0; // Chirp shape, in cycles per observation.
+        std::filesystem::path m_path = {}; // File shape.
+        table_type m_table = table_type(1, entry_type{1, 1});
+
+        /** @brief Validates the structure and returns an error message, if any. */
+        std::optional<std::string> error_message() const noexcept
+        {
+            if (this->m_table.empty()) return "Signal must not be empty.";
+            for (const entry_type& x : this->m_table) if (!aftermath::is_finite(x.value)) return "Signal must be finite.";
+
+            return std::nullopt;
+        } // error_message(...)
+
+        /** @exception std::logic_error Validation failed. */
+        void validate() const
+        {
+            std::optional<std::string> message = this->error_message();
+            if (message.has_value()) throw std::logic_error(message.value());
+        } // validate(...)
+
+        /** @return False if the file could not be read. */
+        bool tabulate() noexcept
+        {
+            std::vector<value_type> period{};
+            switch (this->m_shape)
+            {
+            case signal_shape::constant:
+                period = {1};
+                break;
+            case signal_shape::alternating:
+                for (std::size_t k = 0; k < alternating_shape::period; ++k) period.push_back(alternating_shape{}.template operator ()<value_type>(k));
+                break;
+            case signal_shape::periodic:
+                period = this->m_values;
+                break;
+            case signal_shape::chirp:
+                period.reserve(this->m_length);
+                for (std::size_t k = 0; k < this->m_length; ++k)
+                {
+                    // Time starts at one, so that the signal does not open with a zero.
+                    value_type t = static_cast<value_type>(k + 1);
+                    value_type rate = (this->m_end_frequency - this->m_start_frequency) / static_cast<value_type>(this->m_length);
+                    value_type phase = this->m_start_frequency * t + rate * t * t / 2;
+                    period.push_back(this->m_amplitude * std::sin(2 * std::numbers::pi_v<value_type> * phase));
+                } // for (...)
+                break;
+            case signal_shape::file:
+                try
+                {
+                    std::ifstream filestream{this->m_path};
+                    if (filestream.fail()) return false;
+                    value_type x = 0;
+                    while (filestream >> x) period.push_back(x);
+                    if (!filestream.eof()) return false;
+                } // try
+                catch (...)
+                {
+                    return false;
+                } // catch (...)
+                break;
+            } // switch (...)
+
+            this->m_table.clear();
+            this->m_table.reserve(period.size());
+            value_type sum = 0;
+            for (value_type x : period)
+            {
+                sum += x * x;
+                this->m_table.push_back({x, sum});
+            } // for (...)
+            return true;
+        } // tabulate(...)
+
+    public:
+        /** Constant signal. */
+        tabulated_signal() noexcept = default;
+
+        /** Periodic signal repeating \p values.
+         *  @exception std::logic_error Validation failed.
+         */
+        explicit tabulated_signal(const std::vector<value_type>& values)
+            : m_shape(signal_shape::periodic), m_values(values)
+        {
+            this->tabulate();
+            this->validate();
+        } // tabulated_signal(...)
+
+        signal_shape shape() const noexcept { return this->m_shape; }
+
+        bool is_constant() const noexcept { return this->m_shape == signal_shape::constant; }
+
+        std::size_t period() const noexcept { return this->m_table.size(); }
+
+        /** @brief Checks if the table is a genuine period of the signal.
+         *  @details Chirp and file signals are only known for \c period() observations; beyond that the table merely repeats.
+         */
+        bool is_periodic() const noexcept { return this->m_shape != signal_shape::chirp && this->m_shape != signal_shape::file; }
+
+        /** @brief Adds the tabulated values to \p hash.
+         *  @details Unlike the Json description, it changes whenever the values do, e.g., when the file behind a file signal is edited.
+         */
+        void add_to(fingerprint& hash) const noexcept
+        {
+            hash.add_bytes(this->m_shape);
+            hash.add_bytes(this->m_table.size());
+            for (const entry_type& x : this->m_table) hash.add_bytes(x.value);
+        } // add_to(...)
+
+        /** Checks if the signal is identically zero. */
+        bool is_vanishing() const noexcept { return this->m_table.back().cumulative_squared == 0; }
+
+        /** Signal at time \p time >= 1. */
+        value_type at(std::size_t time) const noexcept { return this->m_table[(time - 1) % this->m_table.size()].value; }
+
+        /** Signal at \p phase. */
+        value_type at(const signal_phase& phase) const noexcept { return this->m_table[phase.index].value; }
+
+        /** Sum of squared signal values up to and including \p phase. */
+        value_type cumulative_squared(const signal_phase& phase) const noexcept
+        {
+            return static_cast<value_type>(phase.count_periods) * this->m_table.back().cumulative_squared + this->m_table[phase.index].cumulative_squared;
+        } // cumulative_squared(...)
+
+        /** Moves \p phase to the next observation. */
+        void advance(signal_phase& phase) const noexcept { phase.advance(this->m_table.size()); }
+
+        bool operator ==(const type& other) const noexcept
+        {
+            if (this->m_shape != other.m_shape) return false;
+            if (this->m_table.size() != other.m_table.size()) return false;
+            for (std::size_t k = 0; k < this->m_table.size(); ++k)
+                if (this->m_table[k].value != other.m_table[k].value) return false;
+            return true;
+        } // operator ==(...)
+
+        bool operator !=(const type& other) const noexcept
+        {
+            return !this->operator ==(other);
+        } // operator !=(...)
+
+        friend void to_json(nlohmann::json& j, const type& x) noexcept
+        {
+            j = nlohmann::json{{type::jstr_type, type::shape_names[static_cast<std::size_t>(x.m_shape)]}};
+            switch (x.m_shape)
+            {
+            case signal_shape::periodic:
+                j[std::string(type::jstr_values)] = x.m_values;
+                break;
+            case signal_shape::chirp:
+                j[std::string(type::jstr_length)] = x.m_length;
+                j[std::string(type::jstr_amplitude)] = x.m_amplitude;
+                j[std::string(type::jstr_start_frequency)] = x.m_start_frequency;
+                j[std::string(type::jstr_end_frequency)] = x.m_end_frequency;
+                break;
+            case signal_shape::file:
+                j[std::string(type::jstr_path)] = x.m_path.string();
+                break;
+            default:
+                break;
+            } // switch (...)
+        } // to_json(...)
+
+        friend void from_json(const nlohmann::json& j, type& x)
+        {
+            if (!ropufu::noexcept_json::try_get(j, x))
+                throw std::runtime_error("Parsing <tabulated_signal> failed: " + j.dump());
+        } // from_json(...)
+    }; // struct tabulated_signal
+} // namespace ropufu::sequential::gaussian_mean_hypotheses
+
+namespace ropufu
+{
+    ROPUFU_TMP_TEMPLATE_SIGNATURE
+    struct noexcept_json_serializer<ropufu::sequential::gaussian_mean_hypotheses::ROPUFU_TMP_TYPENAME>
+    {
+        using result_type = ropufu::sequential::gaussian_mean_hypotheses::ROPUFU_TMP_TYPENAME;
+        using shape_type = ropufu::sequential::gaussian_mean_hypotheses::signal_shape;
+
+        static bool try_get(const nlohmann::json& j, result_type& x) noexcept
+        {
+            std::string shape_name;
+            if (!noexcept_json::required(j, result_type::jstr_type, shape_name)) return false;
+
+            bool is_known = false;
+            for (std::size_t k = 0; k < result_type::shape_names.size(); ++k)
+            {
+                if (shape_name != result_type::shape_names[k]) continue;
+                x.m_shape = static_cast<shape_type>(k);
+                is_known = true;
+            } // for (...)
+            if (!is_known) return false;
+
+            std::string path;
+            switch (x.m_shape)
+            {
+            case shape_type::periodic:
+                if (!noexcept_json::required(j, result_type::jstr_values, x.m_values)) return false;
+                break;
+            case shape_type::chirp:
+                if (!noexcept_json::required(j, result_type::jstr_length, x.m_length)) return false;
+                if (!noexcept_json::optional(j, result_type::jstr_amplitude, x.m_amplitude)) return false;
+                if (!noexcept_json::required(j, result_type::jstr_start_frequency, x.m_start_frequency)) return false;
+                if (!noexcept_json::required(j, result_type::jstr_end_frequency, x.m_end_frequency)) return false;
+                break;
+            case shape_type::file:
+                if (!noexcept_json::required(j, result_type::jstr_path, path)) return false;
+                x.m_path = path;
+                break;
+            default:
+                break;
+            } // switch (...)
+
+            if (!x.tabulate()) return false;
+            if (x.error_message().has_value()) return false;
+
+            return true;
+        } // try_get(...)
+    }; // struct noexcept_json_serializer<...>
+} // namespace ropufu
+
+namespace std
+{
+    ROPUFU_TMP_TEMPLATE_SIGNATURE
+    struct hash<ropufu::sequential::gaussian_mean_hypotheses::ROPUFU_TMP_TYPENAME>
+    {
+        using argument_type = ropufu::sequential::gaussian_mean_hypotheses::ROPUFU_TMP_TYPENAME;
+        using result_type = std::size_t;
+
+        result_type operator ()(argument_type const& x) const noexcept
+        {
+            std::hash<typename argument_type::value_type> value_hasher{};
+            result_type result = static_cast<result_type>(x.m_shape);
+            for (const auto& entry : x.m_table)
+                result = (result << 1) ^ (result >> (sizeof(result_type) * 8 - 1)) ^ value_hasher(entry.value);
+            return result;
+        } // operator ()(...)
+    }; // struct hash<...>
+} // namespace std
+
+#endif // ROPUFU_SEQUENTIAL_GAUSSIAN_MEAN_HYPOTHESES_SIGNAL_HPP_INCLUDED
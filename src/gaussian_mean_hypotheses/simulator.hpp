@@ -6,71 +6,373 @@
 #include <ropufu/random/standard_normal_sampler_512.hpp>
 #include <ropufu/sequential/iid_process.hpp>
 
+#include "kernels.hpp"
 #include "model.hpp"
+#include "multichannel_signal.hpp"
+#include "noise_pipeline.hpp"
+#include "noise_trace.hpp"
 #include "xsprt.hpp"
 
+#include <algorithm>   // std::copy_n, std::min
+#include <atomic>      // std::atomic_size_t, std::memory_order_relaxed
+#include <bit>         // std::bit_ceil
+#include <cmath>       // std::ceil
 #include <concepts>    // std::floating_point
 #include <cstddef>     // std::size_t
 #include <random>      // std::seed_seq
+#include <span>        // std::span
+#include <vector>      // std::vector
 
 namespace ropufu::sequential::gaussian_mean_hypotheses
 {
-    template <std::floating_point t_value_type, typename t_engine_type>
+    /** Counts of noise samples generated by simulators and actually observed by their paths, shared between threads. */
+    struct noise_usage
+    {
+    private:
+        std::atomic_size_t m_count_generated = 0;
+        std::atomic_size_t m_count_used = 0;
+
+    public:
+        noise_usage() noexcept = default;
+
+        noise_usage(const noise_usage&) = delete;
+        noise_usage& operator =(const noise_usage&) = delete;
+
+        void add(std::size_t count_generated, std::size_t count_used) noexcept
+        {
+            this->m_count_generated.fetch_add(count_generated, std::memory_order_relaxed);
+            this->m_count_used.fetch_add(count_used, std::memory_order_relaxed);
+        } // add(...)
+
+        std::size_t count_generated() const noexcept { return this->m_count_generated.load(std::memory_order_relaxed); }
+
+        std::size_t count_used() const noexcept { return this->m_count_used.load(std::memory_order_relaxed); }
+
+        /** Samples generated but never observed; only meaningful once the simulators are done. */
+        std::size_t count_wasted() const noexcept { return this->count_generated() - this->count_used(); }
+    }; // struct noise_usage
+
+    /** @brief Simulates paths of the statistic one at a time.
+     *  @details Noise is generated in blocks sized to the typical path length: initially the anticipated sample size,
+     *  later the running mean of the observed lengths. Every path stops consuming noise exactly when its last rule stops,
+     *  and the rest of the block is carried over to the next path.
+     */
+    template <std::floating_point t_value_type, typename t_engine_type, xsprt_rule... t_extra_rule_types>
     struct simulator
     {
-        using type = simulator<t_value_type, t_engine_type>;
+        using type = simulator<t_value_type, t_engine_type, t_extra_rule_types...>;
         using value_type = t_value_type;
         using engine_type = t_engine_type;
 
         using sampler_type = ropufu::aftermath::random::standard_normal_sampler_512<engine_type, value_type>;
         using process_type = ropufu::aftermath::sequential::iid_process<sampler_type>;
-        using statistic_type = xsprt<value_type>;
+        using statistic_type = xsprt<value_type, t_extra_rule_types...>;
         using output_type = typename statistic_type::output_type;
+        using noise_trace_type = noise_trace<value_type>;
+        using noise_pipeline_type = noise_pipeline<process_type>;
+        using noise_feed_type = typename noise_pipeline_type::feed;
+
+        using observation_container_type = typename process_type::container_type;
 
-        static constexpr std::size_t block_size = 100;
+        /** Bounds on the number of observations (of every channel) generated at once. */
+        static constexpr std::size_t min_block_size = 16;
+        static constexpr std::size_t max_block_size = 4096;
+        /** Number of recent paths the mean path length effectively averages over. */
+        static constexpr std::size_t path_length_window = 32;
 
     private:
         process_type m_noise = {};
         statistic_type m_statistic = {};
+        noise_trace_type* m_trace = nullptr;
+        bool m_is_recording = false;
+        noise_feed_type* m_feed = nullptr;
+        noise_usage* m_usage = nullptr;
+        observation_container_type m_block = {}; // Noise generated by the simulator itself.
+        std::span<value_type> m_feed_block = {}; // Noise last taken from the pipeline.
+        std::size_t m_offset = 0; // Position of the first unused value in the current block.
+        std::vector<value_type> m_replay_rows = {}; // Scratch space for replaying multi-channel traces.
+        value_type m_mean_path_length = 0;
+        std::size_t m_count_paths = 0;
+        std::size_t m_count_generated = 0; // Not yet reported to \c m_usage.
+        std::size_t m_count_used = 0; // Not yet reported to \c m_usage.
+
+        /** Unused noise of the current block, carried over from earlier paths. */
+        std::span<value_type> pending() noexcept
+        {
+            std::span<value_type> block = (this->m_feed == nullptr) ? std::span<value_type>(this->m_block.data(), this->m_block.size()) : this->m_feed_block;
+            return block.subspan(this->m_offset);
+        } // pending(...)
+
+        /** Replaces the (fully used) current block with fresh noise. */
+        void refill(std::size_t count_channels) noexcept
+        {
+            this->m_offset = 0;
+            if (this->m_feed != nullptr)
+            {
+                this->m_feed_block = this->m_feed->next();
+                this->m_count_generated += this->m_feed_block.size();
+                return;
+            } // if (...)
+
+            std::size_t block_length = type::block_size_for(this->m_mean_path_length) * count_channels;
+            if (this->m_block.size() != block_length) this->m_block = observation_container_type(block_length);
+            this->m_noise.next(this->m_block);
+            this->m_count_generated += block_length;
+        } // refill(...)
+
+        /** Marks the leading \p count values of the pending noise as used. */
+        void consume(std::size_t count) noexcept
+        {
+            this->m_offset += count;
+            this->m_count_used += count;
+        } // consume(...)
+
+        /** Throws away the pending noise, e.g. because it has been recorded as part of a finished path. */
+        void discard_pending() noexcept
+        {
+            this->m_offset += this->pending().size();
+        } // discard_pending(...)
+
+        /** Updates the typical path length and reports noise usage. */
+        void finish_path(std::size_t path_length) noexcept
+        {
+            if (this->m_count_paths < type::path_length_window) ++this->m_count_paths;
+            this->m_mean_path_length += (static_cast<value_type>(path_length) - this->m_mean_path_length) / static_cast<value_type>(this->m_count_paths);
+
+            if (this->m_usage == nullptr) return;
+            this->m_usage->add(this->m_count_generated, this->m_count_used);
+            this->m_count_generated = 0;
+            this->m_count_used = 0;
+        } // finish_path(...)
 
     public:
         simulator() noexcept = default;
 
         explicit simulator(const statistic_type& statistic) noexcept
-            : m_statistic(statistic)
+            : m_statistic(statistic), m_mean_path_length(statistic.anticipated_sample_size())
         {
         } // simulator(...)
 
+        /** Number of observations of every channel generated at once for paths of typical length \p expected_path_length. */
+        static std::size_t block_size_for(value_type expected_path_length) noexcept
+        {
+            if (!(expected_path_length > static_cast<value_type>(type::min_block_size))) return type::min_block_size;
+            if (expected_path_length >= static_cast<value_type>(type::max_block_size)) return type::max_block_size;
+            return std::bit_ceil(static_cast<std::size_t>(std::ceil(expected_path_length)));
+        } // block_size_for(...)
+
         void seed(std::seed_seq& sequence) noexcept
         {
             this->m_noise.seed(sequence);
         } // seed(...)
 
+        /** @brief Takes noise blocks from \p feed instead of generating them.
+         *  @details The blocks of \p feed must consist of whole rows of observations of every channel.
+         */
+        void attach_feed(noise_feed_type& feed) noexcept
+        {
+            this->m_feed = &feed;
+            this->m_feed_block = {};
+            this->m_offset = 0;
+        } // attach_feed(...)
+
+        /** Reports the noise generated and observed after every path to \p usage. */
+        void count_usage_in(noise_usage& usage) noexcept
+        {
+            this->m_usage = &usage;
+        } // count_usage_in(...)
+
+        /** Generates fresh noise for every path. */
+        void detach_trace() noexcept
+        {
+            this->m_trace = nullptr;
+            this->m_is_recording = false;
+        } // detach_trace(...)
+
+        /** Stores the leading noise of every path in \p trace, as long as it has free slots. */
+        void record_to(noise_trace_type& trace) noexcept
+        {
+            this->m_trace = &trace;
+            this->m_is_recording = true;
+        } // record_to(...)
+
+        /** @brief Reuses the noise recorded in \p trace; paths that outrun their recording continue with fresh noise.
+         *  @pre \p trace was recorded with as many channels as the model; opening a trace checks it.
+         */
+        void replay_from(noise_trace_type& trace) noexcept
+        {
+            this->m_trace = &trace;
+            this->m_is_recording = false;
+        } // replay_from(...)
+
+        /** Simulates a single path, built for the selected instruction set. */
         output_type operator ()() noexcept
         {
-            using model_type = typename statistic_type::model_type;
-            using observation_container_type = typename process_type::container_type;
+            return kernels::run<value_type>([this] () noexcept { return this->simulate_model(); });
+        } // operator ()(...)
 
-            const model_type& model = this->m_statistic.model();
+    private:
+        output_type simulate_model() noexcept
+        {
+            if (this->m_statistic.model().is_multichannel()) return this->simulate_channels(this->m_statistic.model().channels());
+
+            // Shapes known at compile time skip the table lookup altogether.
+            switch (this->m_statistic.model().signal().shape())
+            {
+            case signal_shape::constant: return this->simulate(constant_signal<value_type>{});
+            case signal_shape::alternating: return this->simulate(constexpr_signal<value_type, alternating_shape>{});
+            default: break;
+            } // switch (...)
+            return this->simulate(this->m_statistic.model().signal());
+        } // simulate_model(...)
+
+        /** Simulates a single path, with \p signal equivalent to the signal of the model. */
+        template <typename t_signal_type>
+        output_type simulate(const t_signal_type& signal) noexcept
+        {
             value_type signal_strength = this->m_statistic.simulated_signal_strength();
             
             this->m_noise.clear(); // Reset driving process.
             this->m_statistic.reset(); // Reset the statistic.
 
-            // Pre-allocate observations block.
-            observation_container_type block = observation_container_type(type::block_size);
+            std::size_t time = 0;
+            signal_phase phase = {};
+            std::size_t path_index = (this->m_trace == nullptr) ? 0 : this->m_trace->claim();
+            bool has_slot = (this->m_trace != nullptr) && (path_index < this->m_trace->count_paths());
+            std::span<value_type> record_slot = {};
+            std::size_t count_recorded = 0;
+
+            if (has_slot && this->m_is_recording) record_slot = this->m_trace->slot(path_index);
+            else if (has_slot)
+            {
+                // Observe recorded noise in place.
+                for (value_type w : this->m_trace->recorded(path_index))
+                {
+                    if (!this->m_statistic.is_running()) break;
+                    ++time;
+                    this->m_statistic.observe(w + signal_strength * signal.at(phase), signal);
+                    signal.advance(phase);
+                } // for (...)
+            } // else if (...)
+
             while (this->m_statistic.is_running())
             {
-                std::size_t time = this->m_noise.count();
-                // Generate new signal + noise values.
-                this->m_noise.next(block);
-                for (value_type& x : block) x += signal_strength * model.signal_at(++time);
-                // Update stopping times.
-                for (value_type& x : block) this->m_statistic.observe(x);
+                std::span<value_type> noise = this->pending();
+                if (noise.empty())
+                {
+                    this->refill(1);
+                    continue;
+                } // if (...)
+                if (count_recorded < record_slot.size())
+                {
+                    std::size_t count_to_record = std::min(noise.size(), record_slot.size() - count_recorded);
+                    std::copy_n(noise.begin(), count_to_record, record_slot.begin() + count_recorded);
+                    count_recorded += count_to_record;
+                } // if (...)
+                // Add signal and update stopping times, up to the moment the last one stops.
+                std::size_t count_used = 0;
+                for (value_type& x : noise)
+                {
+                    ++time;
+                    x += signal_strength * signal.at(phase);
+                    signal.advance(phase);
+                    this->m_statistic.observe(x, signal);
+                    ++count_used;
+                    if (!this->m_statistic.is_running()) break;
+                } // for (...)
+                this->consume(count_used);
             } // while (...)
+            if (!record_slot.empty())
+            {
+                this->m_trace->commit(path_index, count_recorded);
+                this->discard_pending(); // The rest of the block has been recorded as part of this path.
+            } // if (...)
+            this->finish_path(time);
             
             return this->m_statistic.output();
-        } // operator ()(...)
+        } // simulate(...)
+
+        /** @brief Adds the signal to consecutive observations of every channel, stored row by row in \p rows, and observes them.
+         *  @return Number of values observed: whole rows, up to the moment the last stopping time stops.
+         */
+        std::size_t observe_rows(std::span<value_type> rows, const multichannel_signal<value_type>& signal, value_type signal_strength, std::size_t& time, signal_phase& phase) noexcept
+        {
+            const std::size_t count_channels = signal.count_channels();
+            std::size_t offset = 0;
+            while (offset < rows.size())
+            {
+                std::span<value_type> row = rows.subspan(offset, count_channels);
+                ++time;
+                signal.add_to(phase, signal_strength, row);
+                signal.advance(phase);
+                this->m_statistic.observe(row, signal);
+                offset += count_channels;
+                if (!this->m_statistic.is_running()) break;
+            } // while (...)
+            return offset;
+        } // observe_rows(...)
+
+        /** @brief Simulates a single path of a multi-channel model.
+         *  @details The noise of all channels over a block of observations is generated in a single call.
+         *  Noise traces store the channels row by row, so each recorded path covers fewer observations.
+         */
+        output_type simulate_channels(const multichannel_signal<value_type>& signal) noexcept
+        {
+            const std::size_t count_channels = signal.count_channels();
+            value_type signal_strength = this->m_statistic.simulated_signal_strength();
+
+            this->m_noise.clear(); // Reset driving process.
+            this->m_statistic.reset(); // Reset the statistic.
+
+            std::size_t time = 0;
+            signal_phase phase = {};
+            std::size_t path_index = (this->m_trace == nullptr) ? 0 : this->m_trace->claim();
+            bool has_slot = (this->m_trace != nullptr) && (path_index < this->m_trace->count_paths());
+            std::span<value_type> record_slot = {};
+            std::size_t count_recorded = 0;
+
+            if (has_slot && this->m_is_recording) record_slot = this->m_trace->slot(path_index);
+            else if (has_slot)
+            {
+                // Observe recorded noise, whole rows only: a slot may end in the middle of a row.
+                std::span<const value_type> recorded = this->m_trace->recorded(path_index);
+                recorded = recorded.first(recorded.size() - recorded.size() % count_channels);
+                this->m_replay_rows.resize(std::min(recorded.size(), type::max_block_size * count_channels));
+                std::span<value_type> rows{this->m_replay_rows.data(), this->m_replay_rows.size()};
+                while (!recorded.empty() && this->m_statistic.is_running())
+                {
+                    std::size_t count = std::min(rows.size(), recorded.size());
+                    std::copy_n(recorded.begin(), count, rows.begin());
+                    recorded = recorded.subspan(count);
+                    this->observe_rows(rows.first(count), signal, signal_strength, time, phase);
+                } // while (...)
+            } // else if (...)
+
+            while (this->m_statistic.is_running())
+            {
+                std::span<value_type> rows = this->pending();
+                if (rows.empty())
+                {
+                    this->refill(count_channels);
+                    continue;
+                } // if (...)
+                if (count_recorded < record_slot.size())
+                {
+                    std::size_t count_to_record = std::min(rows.size(), record_slot.size() - count_recorded);
+                    std::copy_n(rows.begin(), count_to_record, record_slot.begin() + count_recorded);
+                    count_recorded += count_to_record;
+                } // if (...)
+                this->consume(this->observe_rows(rows, signal, signal_strength, time, phase));
+            } // while (...)
+            if (!record_slot.empty())
+            {
+                this->m_trace->commit(path_index, count_recorded);
+                this->discard_pending(); // The rest of the block has been recorded as part of this path.
+            } // if (...)
+            this->finish_path(time);
+
+            return this->m_statistic.output();
+        } // simulate_channels(...)
     }; // struct simulator
 } // namespace ropufu::sequential::gaussian_mean_hypotheses
 
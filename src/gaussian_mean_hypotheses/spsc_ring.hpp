@@ -0,0 +1,73 @@
+
+#ifndef ROPUFU_SEQUENTIAL_GAUSSIAN_MEAN_HYPOTHESES_SPSC_RING_HPP_INCLUDED
+#define ROPUFU_SEQUENTIAL_GAUSSIAN_MEAN_HYPOTHESES_SPSC_RING_HPP_INCLUDED
+
+#include <atomic>  // std::atomic_size_t, std::memory_order_acquire, std::memory_order_release, std::memory_order_relaxed
+#include <bit>     // std::bit_ceil
+#include <cstddef> // std::size_t
+#include <vector>  // std::vector
+
+namespace ropufu::sequential::gaussian_mean_hypotheses
+{
+    /** @brief Lock-free ring of reusable slots between exactly one producer thread and exactly one consumer thread.
+     *  @details Slots are written and read in place: the producer fills the slot returned by \c try_write and publishes it
+     *  with \c commit_write; the consumer uses the slot returned by \c try_read until it hands it back with \c commit_read.
+     *  Indices owned by either side are kept on separate cache lines.
+     */
+    template <typename t_slot_type>
+    struct spsc_ring
+    {
+        using type = spsc_ring<t_slot_type>;
+        using slot_type = t_slot_type;
+
+    private:
+        std::vector<slot_type> m_slots;
+        std::size_t m_mask;
+        alignas(64) std::atomic_size_t m_head = 0; // Next slot to be read; advanced by the consumer.
+        alignas(64) std::atomic_size_t m_tail = 0; // Next slot to be written; advanced by the producer.
+
+    public:
+        /** @param capacity Number of slots, rounded up to a power of two.
+         *  @param prototype Initial value of every slot.
+         */
+        spsc_ring(std::size_t capacity, const slot_type& prototype)
+            : m_slots(std::bit_ceil(capacity == 0 ? 1 : capacity), prototype), m_mask(std::bit_ceil(capacity == 0 ? 1 : capacity) - 1)
+        {
+        } // spsc_ring(...)
+
+        spsc_ring(const type&) = delete;
+        type& operator =(const type&) = delete;
+
+        std::size_t capacity() const noexcept { return this->m_slots.size(); }
+
+        /** Producer side: slot to be filled, or null if the ring is full. */
+        slot_type* try_write() noexcept
+        {
+            std::size_t tail = this->m_tail.load(std::memory_order_relaxed);
+            if (tail - this->m_head.load(std::memory_order_acquire) == this->m_slots.size()) return nullptr;
+            return &this->m_slots[tail & this->m_mask];
+        } // try_write(...)
+
+        /** Producer side: publishes the slot returned by the last \c try_write. */
+        void commit_write() noexcept
+        {
+            this->m_tail.store(this->m_tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        } // commit_write(...)
+
+        /** Consumer side: oldest published slot, or null if the ring is empty. */
+        slot_type* try_read() noexcept
+        {
+            std::size_t head = this->m_head.load(std::memory_order_relaxed);
+            if (head == this->m_tail.load(std::memory_order_acquire)) return nullptr;
+            return &this->m_slots[head & this->m_mask];
+        } // try_read(...)
+
+        /** Consumer side: hands the slot returned by the last \c try_read back to the producer. */
+        void commit_read() noexcept
+        {
+            this->m_head.store(this->m_head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        } // commit_read(...)
+    }; // struct spsc_ring
+} // namespace ropufu::sequential::gaussian_mean_hypotheses
+
+#endif // ROPUFU_SEQUENTIAL_GAUSSIAN_MEAN_HYPOTHESES_SPSC_RING_HPP_INCLUDED
@@ -0,0 +1,199 @@
+
+#ifndef ROPUFU_SEQUENTIAL_GAUSSIAN_MEAN_HYPOTHESES_STOPPING_TIME_HISTOGRAM_HPP_INCLUDED
+#define ROPUFU_SEQUENTIAL_GAUSSIAN_MEAN_HYPOTHESES_STOPPING_TIME_HISTOGRAM_HPP_INCLUDED
+
+#include <ropufu/algebra/matrix.hpp>
+
+#include "binary_archive.hpp"
+
+#include <bit>       // std::bit_width
+#include <concepts>  // std::floating_point
+#include <cstddef>   // std::size_t
+#include <cstdint>   // std::uint32_t
+#include <stdexcept> // std::logic_error, std::runtime_error
+#include <utility>   // std::move
+#include <vector>    // std::vector
+
+namespace ropufu::sequential::gaussian_mean_hypotheses
+{
+    /** @brief Log-bucketed histograms of stopping times, one per cell of a threshold grid.
+     *  @details Times below \c sub_buckets are counted exactly; every further power of two is split into
+     *  \c sub_buckets equal buckets, so quantiles are reported to within half a bucket, about 6% of the time.
+     *  Counts are stored bucket by bucket, each bucket holding all cells, and grow only as far as the longest time observed:
+     *  memory is proportional to the number of cells and to the logarithm of the longest stopping time.
+     */
+    template <std::floating_point t_value_type>
+    struct stopping_time_histogram
+    {
+        using type = stopping_time_histogram<t_value_type>;
+        using value_type = t_value_type;
+        using count_type = std::uint32_t;
+
+        template <typename t_data_type>
+        using matrix_t = ropufu::aftermath::algebra::matrix<t_data_type>;
+
+        static constexpr std::size_t sub_bucket_bits = 3;
+        static constexpr std::size_t sub_buckets = 1 << sub_bucket_bits;
+
+    private:
+        std::size_t m_height = 0;
+        std::size_t m_width = 0;
+        std::size_t m_count_observations = 0;
+        std::vector<count_type> m_counts = {}; // Bucket-major: counts of bucket b start at b * height * width.
+
+        std::size_t count_cells() const noexcept { return this->m_height * this->m_width; }
+
+        std::size_t count_buckets() const noexcept { return this->empty() ? 0 : (this->m_counts.size() / this->count_cells()); }
+
+        void ensure_buckets(std::size_t count_buckets)
+        {
+            if (count_buckets > this->count_buckets()) this->m_counts.resize(count_buckets * this->count_cells(), 0);
+        } // ensure_buckets(...)
+
+    public:
+        stopping_time_histogram() noexcept = default;
+
+        stopping_time_histogram(std::size_t height, std::size_t width) noexcept
+            : m_height(height), m_width(width)
+        {
+        } // stopping_time_histogram(...)
+
+        /** Bucket containing stopping time \p time. */
+        static constexpr std::size_t bucket_of(std::size_t time) noexcept
+        {
+            if (time < type::sub_buckets) return time;
+            std::size_t shift = static_cast<std::size_t>(std::bit_width(time)) - 1 - type::sub_bucket_bits;
+            return type::sub_buckets * (shift + 1) + ((time >> shift) - type::sub_buckets);
+        } // bucket_of(...)
+
+        /** Smallest stopping time in bucket \p bucket. */
+        static constexpr std::size_t lower_bound_of(std::size_t bucket) noexcept
+        {
+            if (bucket < type::sub_buckets) return bucket;
+            std::size_t shift = bucket / type::sub_buckets - 1;
+            return (type::sub_buckets + bucket % type::sub_buckets) << shift;
+        } // lower_bound_of(...)
+
+        /** Midpoint of the stopping times in bucket \p bucket. */
+        static constexpr value_type representative_of(std::size_t bucket) noexcept
+        {
+            std::size_t lower = type::lower_bound_of(bucket);
+            std::size_t upper = type::lower_bound_of(bucket + 1) - 1;
+            return (static_cast<value_type>(lower) + static_cast<value_type>(upper)) / 2;
+        } // representative_of(...)
+
+        bool empty() const noexcept { return this->m_height == 0 || this->m_width == 0; }
+
+        std::size_t height() const noexcept { return this->m_height; }
+        std::size_t width() const noexcept { return this->m_width; }
+
+        /** Number of paths observed. */
+        std::size_t count() const noexcept { return this->m_count_observations; }
+
+        /** Adds the stopping times of a single path. */
+        void observe(const matrix_t<std::size_t>& when_stopped)
+        {
+            std::size_t count_cells = this->count_cells();
+            std::size_t count_buckets = this->count_buckets();
+            std::size_t cell = 0;
+            for (std::size_t i = 0; i < this->m_height; ++i)
+            {
+                for (std::size_t j = 0; j < this->m_width; ++j)
+                {
+                    std::size_t bucket = type::bucket_of(when_stopped(i, j));
+                    if (bucket >= count_buckets) [[unlikely]]
+                    {
+                        count_buckets = bucket + 1;
+                        this->ensure_buckets(count_buckets);
+                    } // if (...)
+                    ++this->m_counts[bucket * count_cells + cell];
+                    ++cell;
+                } // for (...)
+            } // for (...)
+            ++this->m_count_observations;
+        } // observe(...)
+
+        /** @brief Adds a single stopping time.
+         *  @exception std::logic_error Histogram is not of a single cell.
+         */
+        void observe(std::size_t time)
+        {
+            if (this->m_height != 1 || this->m_width != 1) throw std::logic_error("Histogram must be of a single cell.");
+            std::size_t bucket = type::bucket_of(time);
+            this->ensure_buckets(bucket + 1);
+            ++this->m_counts[bucket];
+            ++this->m_count_observations;
+        } // observe(...)
+
+        /** @exception std::logic_error Histograms are of different sizes. */
+        void merge(const type& other)
+        {
+            if (other.m_count_observations == 0) return;
+            if (this->m_count_observations == 0)
+            {
+                *this = other;
+                return;
+            } // if (...)
+            if (this->m_height != other.m_height || this->m_width != other.m_width) throw std::logic_error("Histograms must be of the same size.");
+
+            this->ensure_buckets(other.count_buckets());
+            for (std::size_t k = 0; k < other.m_counts.size(); ++k) this->m_counts[k] += other.m_counts[k];
+            this->m_count_observations += other.m_count_observations;
+        } // merge(...)
+
+        /** @brief Quantile \p probability of the stopping time in every cell.
+         *  @param probability Between zero and one.
+         */
+        matrix_t<value_type> quantile(value_type probability) const noexcept
+        {
+            matrix_t<value_type> result = matrix_t<value_type>(this->m_height, this->m_width);
+            if (this->m_count_observations == 0) return result;
+
+            value_type rank = probability * static_cast<value_type>(this->m_count_observations);
+            if (rank < 1) rank = 1;
+            std::size_t count_cells = this->count_cells();
+            std::size_t count_buckets = this->count_buckets();
+            std::size_t cell = 0;
+            for (std::size_t i = 0; i < this->m_height; ++i)
+            {
+                for (std::size_t j = 0; j < this->m_width; ++j)
+                {
+                    std::size_t cumulative_count = 0;
+                    std::size_t bucket = 0;
+                    for (; bucket + 1 < count_buckets; ++bucket)
+                    {
+                        cumulative_count += this->m_counts[bucket * count_cells + cell];
+                        if (static_cast<value_type>(cumulative_count) >= rank) break;
+                    } // for (...)
+                    result(i, j) = type::representative_of(bucket);
+                    ++cell;
+                } // for (...)
+            } // for (...)
+            return result;
+        } // quantile(...)
+
+        void write(binary_writer& writer) const
+        {
+            writer.write_size(this->m_height);
+            writer.write_size(this->m_width);
+            writer.write_size(this->m_count_observations);
+            writer.write_vector(this->m_counts);
+        } // write(...)
+
+        /** @exception std::runtime_error Stream ended early, or the stored counts do not fit the grid. */
+        void read(binary_reader& reader)
+        {
+            type result{};
+            result.m_height = reader.read_size();
+            result.m_width = reader.read_size();
+            result.m_count_observations = reader.read_size();
+            reader.read_vector(result.m_counts);
+            if (result.empty() ? !result.m_counts.empty() : (result.m_counts.size() % result.count_cells() != 0))
+                throw std::runtime_error("Stored counts do not fit the grid.");
+
+            *this = std::move(result);
+        } // read(...)
+    }; // struct stopping_time_histogram
+} // namespace ropufu::sequential::gaussian_mean_hypotheses
+
+#endif // ROPUFU_SEQUENTIAL_GAUSSIAN_MEAN_HYPOTHESES_STOPPING_TIME_HISTOGRAM_HPP_INCLUDED
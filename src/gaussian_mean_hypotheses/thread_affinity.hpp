@@ -0,0 +1,89 @@
+
+#ifndef ROPUFU_SEQUENTIAL_GAUSSIAN_MEAN_HYPOTHESES_THREAD_AFFINITY_HPP_INCLUDED
+#define ROPUFU_SEQUENTIAL_GAUSSIAN_MEAN_HYPOTHESES_THREAD_AFFINITY_HPP_INCLUDED
+
+#include <cstddef> // std::size_t
+#include <thread>  // std::thread::hardware_concurrency
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h> // ::GetProcessAffinityMask, ::SetThreadAffinityMask
+#elif defined(__linux__)
+#include <pthread.h> // ::pthread_setaffinity_np
+#include <sched.h>   // ::sched_getaffinity, CPU_SET, CPU_ISSET
+#endif
+
+namespace ropufu::sequential::gaussian_mean_hypotheses
+{
+    /** Number of processors the current process may run on. */
+    inline std::size_t count_available_processors() noexcept
+    {
+#ifdef _WIN32
+        DWORD_PTR process_mask = 0;
+        DWORD_PTR system_mask = 0;
+        if (::GetProcessAffinityMask(::GetCurrentProcess(), &process_mask, &system_mask) != 0)
+        {
+            std::size_t count = 0;
+            for (; process_mask != 0; process_mask &= process_mask - 1) ++count;
+            if (count != 0) return count;
+        } // if (...)
+#elif defined(__linux__)
+        ::cpu_set_t process_set;
+        CPU_ZERO(&process_set);
+        if (::sched_getaffinity(0, sizeof(process_set), &process_set) == 0)
+        {
+            std::size_t count = static_cast<std::size_t>(CPU_COUNT(&process_set));
+            if (count != 0) return count;
+        } // if (...)
+#endif
+        std::size_t count = std::thread::hardware_concurrency();
+        return (count == 0) ? 1 : count;
+    } // count_available_processors(...)
+
+    /** @brief Pins the calling thread to the processor with position \p index among those available to the process.
+     *  @details Positions wrap around the number of available processors.
+     *  @return False if pinning is not supported on this platform, or has failed.
+     */
+    inline bool pin_current_thread(std::size_t index) noexcept
+    {
+#ifdef _WIN32
+        DWORD_PTR process_mask = 0;
+        DWORD_PTR system_mask = 0;
+        if (::GetProcessAffinityMask(::GetCurrentProcess(), &process_mask, &system_mask) == 0) return false;
+
+        std::size_t position = index % count_available_processors();
+        for (std::size_t bit = 0; bit < sizeof(DWORD_PTR) * 8; ++bit)
+        {
+            DWORD_PTR mask = static_cast<DWORD_PTR>(1) << bit;
+            if ((process_mask & mask) == 0) continue;
+            if (position-- != 0) continue;
+            return ::SetThreadAffinityMask(::GetCurrentThread(), mask) != 0;
+        } // for (...)
+        return false;
+#elif defined(__linux__)
+        ::cpu_set_t process_set;
+        CPU_ZERO(&process_set);
+        if (::sched_getaffinity(0, sizeof(process_set), &process_set) != 0) return false;
+
+        std::size_t position = index % count_available_processors();
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+        {
+            if (!CPU_ISSET(cpu, &process_set)) continue;
+            if (position-- != 0) continue;
+
+            ::cpu_set_t thread_set;
+            CPU_ZERO(&thread_set);
+            CPU_SET(cpu, &thread_set);
+            return ::pthread_setaffinity_np(::pthread_self(), sizeof(thread_set), &thread_set) == 0;
+        } // for (...)
+        return false;
+#else
+        (void)index;
+        return false;
+#endif
+    } // pin_current_thread(...)
+} // namespace ropufu::sequential::gaussian_mean_hypotheses
+
+#endif // ROPUFU_SEQUENTIAL_GAUSSIAN_MEAN_HYPOTHESES_THREAD_AFFINITY_HPP_INCLUDED
@@ -11,27 +11,54 @@
 #include <ropufu/simple_vector.hpp>
 
 #include "model.hpp"
+#include "multichannel_signal.hpp"
 
+#include <array>       // std::array
 #include <cmath>       // std::exp
-#include <concepts>    // std::floating_point, std::same_as
+#include <concepts>    // std::floating_point, std::same_as, std::convertible_to
+#include <cstddef>     // std::size_t
+#include <limits>      // std::numeric_limits
 #include <ranges>      // std::ranges::...
+#include <span>        // std::span
 #include <stdexcept>   // std::logic_error
-#include <utility>     // std::make_pair
+#include <string_view> // std::string_view
+#include <tuple>       // std::tuple, std::get
+#include <utility>     // std::make_pair, std::pair, std::index_sequence, std::make_index_sequence
 
 namespace ropufu::sequential::gaussian_mean_hypotheses
 {
-    template <typename t_type>
+    template <typename t_type, std::size_t t_count_extra_rules = 0>
     struct xsprt_pair
     {
+        static constexpr std::size_t count_rules = 2 + t_count_extra_rules;
+
         t_type adaptive_sprt;
         t_type generalized_sprt;
+        /** Additional stopping rules, in the order they were registered with \c xsprt. */
+        std::array<t_type, t_count_extra_rules> extra_rules;
+
+        /** Rule at position \p index: ASPRT, GSPRT, then the additional rules. */
+        t_type& rule(std::size_t index) noexcept
+        {
+            if (index == 0) return this->adaptive_sprt;
+            if (index == 1) return this->generalized_sprt;
+            return this->extra_rules[index - 2];
+        } // rule(...)
+
+        /** Rule at position \p index: ASPRT, GSPRT, then the additional rules. */
+        const t_type& rule(std::size_t index) const noexcept
+        {
+            if (index == 0) return this->adaptive_sprt;
+            if (index == 1) return this->generalized_sprt;
+            return this->extra_rules[index - 2];
+        } // rule(...)
     }; // struct xsprt_pair
 
-    template <std::floating_point t_value_type>
+    template <std::floating_point t_value_type, std::size_t t_count_extra_rules = 0>
     struct xsprt_output
     {
         template <typename t_data_type>
-        using matrix_pair_t = xsprt_pair<ropufu::aftermath::algebra::matrix<t_data_type>>;
+        using matrix_pair_t = xsprt_pair<ropufu::aftermath::algebra::matrix<t_data_type>, t_count_extra_rules>;
 
         t_value_type anticipated_sample_size;
 
@@ -44,6 +71,15 @@ namespace ropufu::sequential::gaussian_mean_hypotheses
         /** Estimator of erroneous decision associated with the change of measure. */
         matrix_pair_t<t_value_type> importance_error_indicator;
 
+        /** Indicator of the decision having been forced by truncation rather than made by the rule. */
+        matrix_pair_t<t_value_type> forced_decision_indicator;
+
+        /** Number of observations until every rule stopped, or the path was truncated. */
+        std::size_t path_length;
+
+        /** Indicates that the path reached the maximum sample size before every rule stopped. */
+        bool is_truncated;
+
         std::size_t height() const noexcept { return this->when_stopped.adaptive_sprt.height(); }
         std::size_t width() const noexcept { return this->when_stopped.adaptive_sprt.width(); }
     }; // struct xsprt_output
@@ -71,21 +107,71 @@ namespace ropufu::sequential::gaussian_mean_hypotheses
         } // log_likelihood_ratio_between(...)
     }; // struct xsprt_state
 
-    /** Calculates two stopping times: adaptive SPRT, and generalized SPRT. */
+    /** Everything a stopping rule may rely on after the shared state has been updated. */
     template <std::floating_point t_value_type>
+    struct xsprt_context
+    {
+        using value_type = t_value_type;
+
+        const xsprt_state<value_type>& state;
+        /** Number of observations so far, including the current one. */
+        std::size_t time;
+        /** Contribution of the current observation to \c running_sum_of_signal_times_observation. */
+        value_type signal_times_observation;
+        /** Contribution of the current observation to \c running_sum_of_signal_squared. */
+        value_type signal_squared;
+        /** Maximum likelihood estimator of the signal strength, constrained to be non-negative. */
+        value_type unconstrained_signal_strength_estimator;
+        /** Maximum likelihood estimator of the signal strength under the alternative hypothesis. */
+        value_type alternative_signal_strength_estimator;
+        value_type weakest_signal_strength;
+    }; // struct xsprt_context
+
+    /** @brief Stopping rule evaluated in the same pass as ASPRT and GSPRT.
+     *  @details \c statistic returns the pair of log-likelihood ratios (against the alternative, against the null),
+     *  in the same order as the ASPRT and GSPRT statistics. \c parameters describes everything fixed in the rule,
+     *  and has to change along with it: stored results are only reused for rules of the same name and parameters.
+     */
+    template <typename t_rule_type>
+    concept xsprt_rule = std::floating_point<typename t_rule_type::value_type> &&
+        requires(t_rule_type& rule, const xsprt_context<typename t_rule_type::value_type>& context)
+        {
+            { t_rule_type::name } -> std::convertible_to<std::string_view>;
+            { t_rule_type::parameters } -> std::convertible_to<std::string_view>;
+            { rule.reset() } noexcept;
+            { rule.statistic(context) } noexcept -> std::same_as<std::pair<typename t_rule_type::value_type, typename t_rule_type::value_type>>;
+        };
+
+    /** @brief Calculates two stopping times: adaptive SPRT, and generalized SPRT.
+     *  @tparam t_extra_rule_types Additional stopping rules sharing the same running sums and estimators.
+     */
+    template <std::floating_point t_value_type, xsprt_rule... t_extra_rule_types>
     struct xsprt
         : public ropufu::aftermath::sequential::statistic<t_value_type, void>
     {
-        using type = xsprt<t_value_type>;
+        using type = xsprt<t_value_type, t_extra_rule_types...>;
         using value_type = t_value_type;
 
+        static constexpr std::size_t count_extra_rules = sizeof...(t_extra_rule_types);
+        static constexpr std::array<std::string_view, count_extra_rules> extra_rule_names = {t_extra_rule_types::name...};
+        static constexpr std::array<std::string_view, count_extra_rules> extra_rule_parameters = {t_extra_rule_types::parameters...};
+
+        /** @brief Revision of what is being computed.
+         *  @details Has to be bumped with every change that alters the distribution of the output, so that stored results
+         *  simulated before the change are never pooled with those simulated after it.
+         */
+        static constexpr std::size_t revision = 1;
+
+        static_assert((std::same_as<typename t_extra_rule_types::value_type, value_type> && ...), "Rules have to share the value type.");
+
         template <typename t_data_type>
         using matrix_t = ropufu::aftermath::algebra::matrix<t_data_type>;
         template <typename t_data_type>
-        using matrix_pair_t = xsprt_pair<ropufu::aftermath::algebra::matrix<t_data_type>>;
+        using matrix_pair_t = xsprt_pair<ropufu::aftermath::algebra::matrix<t_data_type>, count_extra_rules>;
         
         using state_type = xsprt_state<value_type>;
-        using output_type = xsprt_output<value_type>;
+        using context_type = xsprt_context<value_type>;
+        using output_type = xsprt_output<value_type, count_extra_rules>;
 
         using model_type = ropufu::sequential::gaussian_mean_hypotheses::model<value_type>;
         using stopping_time_type = ropufu::aftermath::sequential::parallel_stopping_time<value_type, value_type>;
@@ -94,12 +180,67 @@ namespace ropufu::sequential::gaussian_mean_hypotheses
     private:
         model_type m_model = {};
         std::size_t m_count_observations = 0;
+        signal_phase m_phase = {}; // Phase of the next observation.
         state_type m_state = {};
         stopping_time_type m_adaptive_sprt = {};
         stopping_time_type m_generalized_sprt = {};
+        std::tuple<t_extra_rule_types...> m_extra_rules = {};
+        std::array<stopping_time_type, count_extra_rules> m_extra_stopping_times = {};
+        xsprt_pair<std::pair<value_type, value_type>, count_extra_rules> m_latest_statistic = {};
+        value_type m_latest_change_of_measure = 0;
         value_type m_simulated_signal_strength = 0;
         value_type m_change_of_measure_signal_strength = 0;
         value_type m_anticipated_sample_size = 0;
+        std::size_t m_max_sample_size = std::numeric_limits<std::size_t>::max();
+        bool m_is_tracking_statistics_only = false;
+
+        /** Indicates that the statistic of the rule stopping on \p t has to be evaluated. */
+        bool is_evaluated(const stopping_time_type& t) const noexcept
+        {
+            return this->m_is_tracking_statistics_only || t.is_running();
+        } // is_evaluated(...)
+
+        /** Indicates that the grid \p t has to observe the latest statistic of its rule. */
+        bool is_observed(const stopping_time_type& t) const noexcept
+        {
+            return !this->m_is_tracking_statistics_only && t.is_running();
+        } // is_observed(...)
+
+        bool has_running_rules() const noexcept
+        {
+            if (this->m_adaptive_sprt.is_running() || this->m_generalized_sprt.is_running()) return true;
+            for (const stopping_time_type& t : this->m_extra_stopping_times) if (t.is_running()) return true;
+            return false;
+        } // has_running_rules(...)
+
+        /** @brief Decision of a truncated rule, for cells that have not stopped.
+         *  @details The hypothesis favored by the latest statistic: the null if the log-likelihood ratio against the alternative is larger.
+         */
+        static char forced_decision(const std::pair<value_type, value_type>& latest_statistic) noexcept
+        {
+            return (latest_statistic.first >= latest_statistic.second) ? stopping_time_type::decide_vertical : stopping_time_type::decide_horizontal;
+        } // forced_decision(...)
+
+        /** Stopping times, with cells that have not stopped truncated at the current time. */
+        matrix_t<std::size_t> when_stopped(const stopping_time_type& t) const noexcept
+        {
+            matrix_t<std::size_t> result = t.when();
+            if (!t.is_running()) return result;
+            const matrix_t<char>& which = t.which();
+            for (std::size_t i = 0; i < result.height(); ++i)
+                for (std::size_t j = 0; j < result.width(); ++j)
+                    if (which(i, j) == 0) result(i, j) = this->m_count_observations;
+            return result;
+        } // when_stopped(...)
+
+        matrix_t<value_type> forced_decision_indicator(const stopping_time_type& t) const noexcept
+        {
+            const matrix_t<char>& which = t.which();
+            if (!t.is_running()) return matrix_t<value_type>(which.height(), which.width());
+            return matrix_t<value_type>::generate(which.height(), which.width(), [&which] (std::size_t i, std::size_t j) {
+                return (which(i, j) == 0) ? 1 : 0;
+            });
+        } // forced_decision_indicator(...)
 
         char truth(value_type signal_strength) const noexcept
         {
@@ -108,46 +249,92 @@ namespace ropufu::sequential::gaussian_mean_hypotheses
             return 0;
         } // truth(...)
 
-        matrix_t<value_type> direct_error_indicator(const stopping_time_type& t) const noexcept
+        /** @param latest_statistic Latest statistic of the rule, deciding cells that have been truncated. */
+        matrix_t<value_type> direct_error_indicator(const stopping_time_type& t, const std::pair<value_type, value_type>& latest_statistic) const noexcept
         {
             const matrix_t<char>& which = t.which();
             const std::size_t m = which.height();
             const std::size_t n = which.width();
 
             char correct_decision = this->truth(this->m_simulated_signal_strength);
+            char forced_decision = type::forced_decision(latest_statistic);
 
-            return matrix_t<value_type>::generate(m, n, [correct_decision, &which] (std::size_t i, std::size_t j) {
-                return (which(i, j) == correct_decision) ? 0 : 1;
+            return matrix_t<value_type>::generate(m, n, [correct_decision, forced_decision, &which] (std::size_t i, std::size_t j) {
+                char decision = (which(i, j) == 0) ? forced_decision : which(i, j);
+                return (decision == correct_decision) ? 0 : 1;
             });
         } // direct_error_indicator(...)
 
-        matrix_t<value_type> importance_error_indicator(const stopping_time_type& t) const noexcept
+        /** @brief Error indicator weighted by the likelihood ratio at the decision time.
+         *  @details Cells that have been truncated have no stopped statistic: they are weighted by the change of measure at truncation.
+         *  @param latest_statistic Latest statistic of the rule, deciding cells that have been truncated.
+         */
+        matrix_t<value_type> importance_error_indicator(const stopping_time_type& t, const std::pair<value_type, value_type>& latest_statistic) const noexcept
         {
             const matrix_t<char>& which = t.which();
             const std::size_t m = which.height();
             const std::size_t n = which.width();
 
-            matrix_t<value_type> change_of_measure = t.stopped_statistic();
+            const matrix_t<value_type>& change_of_measure = t.stopped_statistic();
+            value_type truncated_change_of_measure = this->m_latest_change_of_measure;
             char correct_decision = this->truth(this->m_change_of_measure_signal_strength);
+            char forced_decision = type::forced_decision(latest_statistic);
 
-            return matrix_t<value_type>::generate(m, n, [correct_decision, &which, &change_of_measure] (std::size_t i, std::size_t j) {
-                return (which(i, j) == correct_decision) ? 0 : std::exp(-change_of_measure(i, j));
+            return matrix_t<value_type>::generate(m, n, [correct_decision, forced_decision, truncated_change_of_measure, &which, &change_of_measure] (std::size_t i, std::size_t j) {
+                bool is_forced = (which(i, j) == 0);
+                char decision = is_forced ? forced_decision : which(i, j);
+                if (decision == correct_decision) return static_cast<value_type>(0);
+                return std::exp(-(is_forced ? truncated_change_of_measure : change_of_measure(i, j)));
             });
         } // importance_error_indicator(...)
 
+        template <std::size_t... t_indices>
+        void reset_extra_rules(std::index_sequence<t_indices...>) noexcept
+        {
+            (std::get<t_indices>(this->m_extra_rules).reset(), ...);
+        } // reset_extra_rules(...)
+
+        template <std::size_t t_index>
+        void observe_extra_rule(const context_type& context) noexcept
+        {
+            stopping_time_type& t = this->m_extra_stopping_times[t_index];
+            if (!this->is_evaluated(t)) return;
+            this->m_latest_statistic.extra_rules[t_index] = std::get<t_index>(this->m_extra_rules).statistic(context);
+            if (this->is_observed(t)) t.observe(this->m_latest_statistic.extra_rules[t_index]);
+        } // observe_extra_rule(...)
+
+        template <std::size_t... t_indices>
+        void observe_extra_rules(const context_type& context, std::index_sequence<t_indices...>) noexcept
+        {
+            (this->template observe_extra_rule<t_indices>(context), ...);
+        } // observe_extra_rules(...)
+
+        /** @param transform Takes a stopping time, and the latest statistic of its rule. */
+        template <typename t_data_type, typename t_transform_type>
+        std::array<matrix_t<t_data_type>, count_extra_rules> transform_extra_rules(t_transform_type&& transform) const noexcept
+        {
+            std::array<matrix_t<t_data_type>, count_extra_rules> result{};
+            for (std::size_t k = 0; k < count_extra_rules; ++k) result[k] = transform(this->m_extra_stopping_times[k], this->m_latest_statistic.extra_rules[k]);
+            return result;
+        } // transform_extra_rules(...)
+
     public:
         xsprt() noexcept = default;
 
+        /** @param extra_rule_thresholds Thresholds for each of \p t_extra_rule_types, in order. */
         explicit xsprt(model_type model,
             const thresholds_type& asprt_thresholds, const thresholds_type& gsprt_thresholds,
             value_type simulated_signal_strength, value_type change_of_measure_signal_strength,
-            value_type anticipated_sample_size) noexcept
+            value_type anticipated_sample_size,
+            const std::array<thresholds_type, count_extra_rules>& extra_rule_thresholds = {}) noexcept
             : m_model(model),
             m_adaptive_sprt(asprt_thresholds.first, asprt_thresholds.second),
             m_generalized_sprt(gsprt_thresholds.first, gsprt_thresholds.second),
             m_simulated_signal_strength(simulated_signal_strength), m_change_of_measure_signal_strength(change_of_measure_signal_strength),
             m_anticipated_sample_size(anticipated_sample_size)
         {
+            for (std::size_t k = 0; k < count_extra_rules; ++k)
+                this->m_extra_stopping_times[k] = stopping_time_type(extra_rule_thresholds[k].first, extra_rule_thresholds[k].second);
         } // xsprt(...)
 
         const model_type& model() const noexcept { return this->m_model; }
@@ -158,20 +345,93 @@ namespace ropufu::sequential::gaussian_mean_hypotheses
 
         value_type anticipated_sample_size() const noexcept { return this->m_anticipated_sample_size; }
 
+        /** Number of observations after which paths are truncated; zero if they are not. */
+        std::size_t max_sample_size() const noexcept
+        {
+            return (this->m_max_sample_size == std::numeric_limits<std::size_t>::max()) ? 0 : this->m_max_sample_size;
+        } // max_sample_size(...)
+
+        /** @brief Stops every path after \p max_sample_size observations; zero removes the truncation.
+         *  @details Cells that have not stopped by then are decided in favor of the hypothesis their rule's latest statistic favors.
+         */
+        void truncate_at(std::size_t max_sample_size) noexcept
+        {
+            this->m_max_sample_size = (max_sample_size == 0) ? std::numeric_limits<std::size_t>::max() : max_sample_size;
+        } // truncate_at(...)
+
+        /** @brief Updates the statistics of every rule on every observation, and leaves their grids untouched.
+         *  @details For callers that only follow the trajectories of the statistics: no grid ever stops,
+         *  so the output is meaningless and only truncation ends \c is_running.
+         *  By default a rule costs nothing once every cell of its grid has stopped, and its latest statistic is no longer updated.
+         */
+        void track_statistics_only(bool value) noexcept
+        {
+            this->m_is_tracking_statistics_only = value;
+        } // track_statistics_only(...)
+
+        std::size_t count_observations() const noexcept { return this->m_count_observations; }
+
+        const stopping_time_type& adaptive_sprt() const noexcept { return this->m_adaptive_sprt; }
+
+        const stopping_time_type& generalized_sprt() const noexcept { return this->m_generalized_sprt; }
+
+        const std::array<stopping_time_type, count_extra_rules>& extra_rules() const noexcept { return this->m_extra_stopping_times; }
+
+        /** Statistics (against the alternative, against the null) of every rule at the latest observation. */
+        const xsprt_pair<std::pair<value_type, value_type>, count_extra_rules>& latest_statistic() const noexcept { return this->m_latest_statistic; }
+
+        /** Log-likelihood ratio between the simulated and the change of measure signal strengths at the latest observation. */
+        value_type latest_change_of_measure() const noexcept { return this->m_latest_change_of_measure; }
+
+        /** Indicates that some rule has not stopped, and the path has not been truncated. */
         bool is_running() const noexcept
         {
-            return this->m_adaptive_sprt.is_running() || this->m_generalized_sprt.is_running();
+            if (this->m_count_observations >= this->m_max_sample_size) return false;
+            return this->has_running_rules();
         } // is_running(...)
 
         void reset() noexcept override
         {
             this->m_count_observations = 0;
+            this->m_phase = {};
             this->m_state = {};
             this->m_adaptive_sprt.reset();
             this->m_generalized_sprt.reset();
+            this->reset_extra_rules(std::make_index_sequence<count_extra_rules>{});
+            for (stopping_time_type& t : this->m_extra_stopping_times) t.reset();
         } // reset(...)
 
+        /** Updates the statistics with an observation of a single-channel model. */
         void observe(const value_type& value) noexcept override
+        {
+            this->observe(value, this->m_model.signal());
+        } // observe(...)
+
+        /** @brief Updates the statistics with an observation, looking up the signal in \p signal.
+         *  @param signal Signal of the underlying model, or an equivalent one with a cheaper lookup.
+         */
+        template <typename t_signal_type>
+        void observe(const value_type& value, const t_signal_type& signal) noexcept
+        {
+            value_type s = signal.at(this->m_phase);
+            this->observe_sufficient(s * value, s * s, signal.cumulative_squared(this->m_phase));
+            signal.advance(this->m_phase);
+        } // observe(...)
+
+        /** Updates the statistics with the current observation of every channel of a multi-channel model. */
+        void observe(std::span<const value_type> values, const multichannel_signal<value_type>& signal) noexcept
+        {
+            this->observe_sufficient(signal.signal_times(this->m_phase, values), signal.energy(this->m_phase), signal.cumulative_squared(this->m_phase));
+            signal.advance(this->m_phase);
+        } // observe(...)
+
+    private:
+        /** @brief Updates the statistics with the sufficient statistics of the current observation.
+         *  @param signal_times_observation Sum of signal times observation across channels.
+         *  @param signal_squared Sum of squared signals across channels.
+         *  @param running_sum_of_signal_squared Sum of squared signals across channels and times so far.
+         */
+        void observe_sufficient(value_type signal_times_observation, value_type signal_squared, value_type running_sum_of_signal_squared) noexcept
         {
             ++this->m_count_observations;
             const std::size_t time = this->m_count_observations;
@@ -180,11 +440,12 @@ namespace ropufu::sequential::gaussian_mean_hypotheses
             // ================================================================
             // Update auxiliary statistics shared by ASPRT and GSPRT (state).
             // ================================================================
-            value_type s = this->m_model.signal_at(time);
-            this->m_state.running_sum_of_signal_times_observation += s * value;
-            this->m_state.running_sum_of_signal_squared += s * s;
+            this->m_state.running_sum_of_signal_times_observation += signal_times_observation;
+            this->m_state.running_sum_of_signal_squared = running_sum_of_signal_squared;
 
-            value_type uncostrained_signal_strength_estimator = this->m_state.running_sum_of_signal_times_observation / this->m_state.running_sum_of_signal_squared;
+            // Signals may open with zeros: until they carry energy, there is nothing to estimate the strength from.
+            value_type uncostrained_signal_strength_estimator = (this->m_state.running_sum_of_signal_squared == 0) ? 0 :
+                this->m_state.running_sum_of_signal_times_observation / this->m_state.running_sum_of_signal_squared;
             if (uncostrained_signal_strength_estimator < 0) uncostrained_signal_strength_estimator = 0;
 
             value_type alternative_signal_strength_estimator =
@@ -194,14 +455,14 @@ namespace ropufu::sequential::gaussian_mean_hypotheses
 
             if (time == 1) [[unlikely]]
             {
-                value_type y = alternative_signal_strength_estimator * s;
+                value_type y = alternative_signal_strength_estimator;
                 this->m_state.adaptive_log_likelihood_init_null = 0;
-                this->m_state.adaptive_log_likelihood_init_alternative = y * (value - y / 2);
+                this->m_state.adaptive_log_likelihood_init_alternative = y * (signal_times_observation - y * signal_squared / 2);
             } // if (...)
             else [[likely]]
             {
-                value_type y = this->m_state.delayed_signal_strength_estimator * s;
-                this->m_state.running_sum_for_adaptive_log_likelihood += y * (value - y / 2);
+                value_type y = this->m_state.delayed_signal_strength_estimator;
+                this->m_state.running_sum_for_adaptive_log_likelihood += y * (signal_times_observation - y * signal_squared / 2);
             } // else (...)
             
             // ================================================================
@@ -210,43 +471,78 @@ namespace ropufu::sequential::gaussian_mean_hypotheses
             value_type change_of_measure = state.log_likelihood_ratio_between(
                 this->m_simulated_signal_strength,
                 this->m_change_of_measure_signal_strength);
-            this->m_adaptive_sprt.if_stopped(change_of_measure);
-            this->m_generalized_sprt.if_stopped(change_of_measure);
+            this->m_latest_change_of_measure = change_of_measure;
+            // Rules whose grids have fully stopped are skipped: none of their cells would record anything.
+            if (this->is_observed(this->m_adaptive_sprt)) this->m_adaptive_sprt.if_stopped(change_of_measure);
+            if (this->is_observed(this->m_generalized_sprt)) this->m_generalized_sprt.if_stopped(change_of_measure);
+            for (stopping_time_type& t : this->m_extra_stopping_times) if (this->is_observed(t)) t.if_stopped(change_of_measure);
 
             // ================================================================
             // Calculate the ASPRT statistic.
             // ================================================================
-            value_type adaptive_log_likelihood_null = state.adaptive_log_likelihood_init_null +
-                state.running_sum_for_adaptive_log_likelihood;
-            value_type adaptive_log_likelihood_alternative = state.adaptive_log_likelihood_init_alternative +
-                state.running_sum_for_adaptive_log_likelihood +
-                state.log_likelihood_ratio_between(0, alternative_signal_strength_estimator);
-            this->m_adaptive_sprt.observe(std::make_pair(adaptive_log_likelihood_alternative, adaptive_log_likelihood_null));
+            if (this->is_evaluated(this->m_adaptive_sprt))
+            {
+                value_type adaptive_log_likelihood_null = state.adaptive_log_likelihood_init_null +
+                    state.running_sum_for_adaptive_log_likelihood;
+                value_type adaptive_log_likelihood_alternative = state.adaptive_log_likelihood_init_alternative +
+                    state.running_sum_for_adaptive_log_likelihood +
+                    state.log_likelihood_ratio_between(0, alternative_signal_strength_estimator);
+                this->m_latest_statistic.adaptive_sprt = std::make_pair(adaptive_log_likelihood_alternative, adaptive_log_likelihood_null);
+                if (this->is_observed(this->m_adaptive_sprt)) this->m_adaptive_sprt.observe(this->m_latest_statistic.adaptive_sprt);
+            } // if (...)
             
             // ================================================================
             // Calculate the GSPRT statistic.
             // ================================================================
-            value_type generalized_log_likelihood_null = state.log_likelihood_ratio_between(uncostrained_signal_strength_estimator, 0);
-            value_type generalized_log_likelihood_alternative = state.log_likelihood_ratio_between(uncostrained_signal_strength_estimator, alternative_signal_strength_estimator);
-            this->m_generalized_sprt.observe(std::make_pair(generalized_log_likelihood_alternative, generalized_log_likelihood_null));
+            if (this->is_evaluated(this->m_generalized_sprt))
+            {
+                value_type generalized_log_likelihood_null = state.log_likelihood_ratio_between(uncostrained_signal_strength_estimator, 0);
+                value_type generalized_log_likelihood_alternative = state.log_likelihood_ratio_between(uncostrained_signal_strength_estimator, alternative_signal_strength_estimator);
+                this->m_latest_statistic.generalized_sprt = std::make_pair(generalized_log_likelihood_alternative, generalized_log_likelihood_null);
+                if (this->is_observed(this->m_generalized_sprt)) this->m_generalized_sprt.observe(this->m_latest_statistic.generalized_sprt);
+            } // if (...)
+
+            // ================================================================
+            // Calculate the statistics of additional rules.
+            // ================================================================
+            if constexpr (count_extra_rules != 0)
+            {
+                context_type context{state, time, signal_times_observation, signal_squared,
+                    uncostrained_signal_strength_estimator, alternative_signal_strength_estimator,
+                    this->m_model.weakest_signal_strength()};
+                this->observe_extra_rules(context, std::make_index_sequence<count_extra_rules>{});
+            } // if constexpr (...)
 
             // ================================================================
             // Update delayed statistics.
             // ================================================================
             this->m_state.delayed_signal_strength_estimator = uncostrained_signal_strength_estimator;
-        } // observe(...)
+        } // observe_sufficient(...)
 
+    public:
+        /** Outcome of the current path; rules that have not stopped are treated as truncated at the current time. */
         output_type output() const noexcept
         {
+            using latest_type = std::pair<value_type, value_type>;
+            const auto& latest = this->m_latest_statistic;
             return {
                 this->m_anticipated_sample_size,
-                matrix_pair_t<std::size_t>(this->m_adaptive_sprt.when(), this->m_generalized_sprt.when()),
+                matrix_pair_t<std::size_t>(this->when_stopped(this->m_adaptive_sprt), this->when_stopped(this->m_generalized_sprt),
+                    this->template transform_extra_rules<std::size_t>([this] (const stopping_time_type& t, const latest_type&) { return this->when_stopped(t); })),
+                matrix_pair_t<value_type>(
+                    this->direct_error_indicator(this->m_adaptive_sprt, latest.adaptive_sprt),
+                    this->direct_error_indicator(this->m_generalized_sprt, latest.generalized_sprt),
+                    this->template transform_extra_rules<value_type>([this] (const stopping_time_type& t, const latest_type& x) { return this->direct_error_indicator(t, x); })),
                 matrix_pair_t<value_type>(
-                    this->direct_error_indicator(this->m_adaptive_sprt),
-                    this->direct_error_indicator(this->m_generalized_sprt)),
+                    this->importance_error_indicator(this->m_adaptive_sprt, latest.adaptive_sprt),
+                    this->importance_error_indicator(this->m_generalized_sprt, latest.generalized_sprt),
+                    this->template transform_extra_rules<value_type>([this] (const stopping_time_type& t, const latest_type& x) { return this->importance_error_indicator(t, x); })),
                 matrix_pair_t<value_type>(
-                    this->importance_error_indicator(this->m_adaptive_sprt),
-                    this->importance_error_indicator(this->m_generalized_sprt))
+                    this->forced_decision_indicator(this->m_adaptive_sprt),
+                    this->forced_decision_indicator(this->m_generalized_sprt),
+                    this->template transform_extra_rules<value_type>([this] (const stopping_time_type& t, const latest_type&) { return this->forced_decision_indicator(t); })),
+                this->m_count_observations,
+                this->has_running_rules()
             };
         } // output(...)
     }; // struct xsprt
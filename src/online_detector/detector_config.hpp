@@ -0,0 +1,131 @@
+
+#ifndef ROPUFU_SEQUENTIAL_ONLINE_DETECTOR_DETECTOR_CONFIG_HPP_INCLUDED
+#define ROPUFU_SEQUENTIAL_ONLINE_DETECTOR_DETECTOR_CONFIG_HPP_INCLUDED
+
+#include <nlohmann/json.hpp>
+#include <ropufu/noexcept_json.hpp>
+
+#include <ropufu/algebra/interval.hpp>
+#include <ropufu/algebra/interval_based_vector.hpp>
+#include <ropufu/algebra/interval_spacing.hpp>
+#include <ropufu/simple_vector.hpp>
+#include <ropufu/vector_extender.hpp>
+
+#include "model.hpp"
+
+#include <concepts>    // std::floating_point
+#include <cstddef>     // std::size_t
+#include <stdexcept>   // std::runtime_error
+#include <string_view> // std::string_view
+#include <utility>     // std::pair
+#include <variant>     // std::variant, std::monostate, std::visit
+
+#ifdef ROPUFU_TMP_TYPENAME
+#undef ROPUFU_TMP_TYPENAME
+#endif
+#ifdef ROPUFU_TMP_TEMPLATE_SIGNATURE
+#undef ROPUFU_TMP_TEMPLATE_SIGNATURE
+#endif
+#define ROPUFU_TMP_TYPENAME detector_config<t_value_type>
+#define ROPUFU_TMP_TEMPLATE_SIGNATURE template <std::floating_point t_value_type>
+
+namespace ropufu::sequential::online_detector
+{
+    ROPUFU_TMP_TEMPLATE_SIGNATURE
+    struct detector_config;
+
+    ROPUFU_TMP_TEMPLATE_SIGNATURE
+    void to_json(nlohmann::json& j, const ROPUFU_TMP_TYPENAME& x) noexcept;
+    ROPUFU_TMP_TEMPLATE_SIGNATURE
+    void from_json(const nlohmann::json& j, ROPUFU_TMP_TYPENAME& x);
+
+    /** Model and threshold pairs of an online detector. */
+    ROPUFU_TMP_TEMPLATE_SIGNATURE
+    struct detector_config
+    {
+        using type = ROPUFU_TMP_TYPENAME;
+        using value_type = t_value_type;
+
+        using model_type = ropufu::sequential::gaussian_mean_hypotheses::model<value_type>;
+        using thresholds_type = std::pair<ropufu::aftermath::simple_vector<value_type>, ropufu::aftermath::simple_vector<value_type>>;
+
+        // ~~ Json names ~~
+        static constexpr std::string_view jstr_model = "model";
+        static constexpr std::string_view jstr_asprt_thresholds = "ASPRT thresholds";
+        static constexpr std::string_view jstr_gsprt_thresholds = "GSPRT thresholds";
+        static constexpr std::string_view jstr_frame_capacity = "frame capacity";
+
+        friend ropufu::noexcept_json_serializer<type>;
+
+        model_type model;
+        thresholds_type asprt_thresholds;
+        thresholds_type gsprt_thresholds;
+        /** Largest number of observations read from the stream at once. */
+        std::size_t frame_capacity = 4'096;
+
+        detector_config() noexcept = default;
+
+        friend void to_json(nlohmann::json& j, const type& x) noexcept
+        {
+            j = nlohmann::json{
+                {type::jstr_model, x.model},
+                {type::jstr_asprt_thresholds, x.asprt_thresholds},
+                {type::jstr_gsprt_thresholds, x.gsprt_thresholds},
+                {type::jstr_frame_capacity, x.frame_capacity}
+            };
+        } // to_json(...)
+
+        friend void from_json(const nlohmann::json& j, type& x)
+        {
+            if (!ropufu::noexcept_json::try_get(j, x))
+                throw std::runtime_error("Parsing <detector_config> failed: " + j.dump());
+        } // from_json(...)
+    }; // struct detector_config
+} // namespace ropufu::sequential::online_detector
+
+namespace ropufu
+{
+    ROPUFU_TMP_TEMPLATE_SIGNATURE
+    struct noexcept_json_serializer<ropufu::sequential::online_detector::ROPUFU_TMP_TYPENAME>
+    {
+        using result_type = ropufu::sequential::online_detector::ROPUFU_TMP_TYPENAME;
+        using value_type = typename result_type::value_type;
+        using initializer_type = ropufu::vector_initializer_t<
+            ropufu::aftermath::algebra::linear_spacing<value_type>,
+            ropufu::aftermath::algebra::logarithmic_spacing<value_type>,
+            ropufu::aftermath::algebra::exponential_spacing<value_type>>;
+
+        static void initialize(const std::pair<initializer_type, initializer_type>& init, typename result_type::thresholds_type& x) noexcept
+        {
+            std::visit([&x] (auto&& arg) {
+                using arg_type = std::decay_t<decltype(arg)>;
+                if constexpr (!std::same_as<arg_type, std::monostate>) arg.explode(x.first);
+            }, init.first);
+
+            std::visit([&x] (auto&& arg) {
+                using arg_type = std::decay_t<decltype(arg)>;
+                if constexpr (!std::same_as<arg_type, std::monostate>) arg.explode(x.second);
+            }, init.second);
+        } // initialize(...)
+
+        static bool try_get(const nlohmann::json& j, result_type& x) noexcept
+        {
+            std::pair<initializer_type, initializer_type> asprt_thresholds;
+            std::pair<initializer_type, initializer_type> gsprt_thresholds;
+
+            if (!noexcept_json::required(j, result_type::jstr_model, x.model)) return false;
+            if (x.model.is_multichannel()) return false; // The stream carries a single channel.
+            if (!noexcept_json::required(j, result_type::jstr_asprt_thresholds, asprt_thresholds)) return false;
+            if (!noexcept_json::required(j, result_type::jstr_gsprt_thresholds, gsprt_thresholds)) return false;
+            if (!noexcept_json::optional(j, result_type::jstr_frame_capacity, x.frame_capacity)) return false;
+            if (x.frame_capacity == 0) return false;
+
+            initialize(asprt_thresholds, x.asprt_thresholds);
+            initialize(gsprt_thresholds, x.gsprt_thresholds);
+
+            return true;
+        } // try_get(...)
+    }; // struct noexcept_json_serializer<...>
+} // namespace ropufu
+
+#endif // ROPUFU_SEQUENTIAL_ONLINE_DETECTOR_DETECTOR_CONFIG_HPP_INCLUDED
@@ -0,0 +1,89 @@
+
+#ifndef ROPUFU_SEQUENTIAL_ONLINE_DETECTOR_FRAME_HPP_INCLUDED
+#define ROPUFU_SEQUENTIAL_ONLINE_DETECTOR_FRAME_HPP_INCLUDED
+
+#include <algorithm>   // std::min
+#include <concepts>    // std::floating_point
+#include <cstddef>     // std::size_t
+#include <cstdint>     // std::uint32_t
+#include <cstdio>      // std::FILE, std::fread, std::fwrite
+#include <span>        // std::span
+#include <vector>      // std::vector
+
+namespace ropufu::sequential::online_detector
+{
+    /** @brief Binary framing of the observation stream.
+     *  @details Each frame is a header, followed by \c count observations in native byte order.
+     */
+    struct frame_header
+    {
+        /** Spells "GMHF" in little-endian byte order. */
+        static constexpr std::uint32_t expected_signature = 0x46484D47;
+
+        std::uint32_t signature = expected_signature;
+        std::uint32_t count = 0;
+    }; // struct frame_header
+
+    /** Reads observations from a framed binary stream in chunks of bounded size. */
+    template <std::floating_point t_value_type>
+    struct frame_reader
+    {
+        using type = frame_reader<t_value_type>;
+        using value_type = t_value_type;
+
+    private:
+        std::FILE* m_stream = nullptr;
+        std::vector<value_type> m_buffer = {};
+        std::size_t m_count_remaining = 0;
+        bool m_is_malformed = false;
+
+    public:
+        frame_reader(std::FILE* stream, std::size_t capacity) noexcept
+            : m_stream(stream), m_buffer(capacity)
+        {
+        } // frame_reader(...)
+
+        /** Indicates that the stream ended mid-frame or contained an invalid header. */
+        bool is_malformed() const noexcept { return this->m_is_malformed; }
+
+        /** @brief Reads the next chunk of observations; empty once the stream has ended. */
+        std::span<const value_type> next() noexcept
+        {
+            while (this->m_count_remaining == 0)
+            {
+                frame_header header{};
+                std::size_t count_bytes = std::fread(&header, 1, sizeof(frame_header), this->m_stream);
+                if (count_bytes == 0) return {}; // End of stream.
+                if (count_bytes != sizeof(frame_header))
+                {
+                    this->m_is_malformed = true; // Stream ended mid-header.
+                    return {};
+                } // if (...)
+                if (header.signature != frame_header::expected_signature)
+                {
+                    this->m_is_malformed = true;
+                    return {};
+                } // if (...)
+                this->m_count_remaining = header.count;
+            } // while (...)
+
+            std::size_t count = std::min(this->m_count_remaining, this->m_buffer.size());
+            std::size_t count_read = std::fread(this->m_buffer.data(), sizeof(value_type), count, this->m_stream);
+            this->m_count_remaining -= count_read;
+            if (count_read != count) this->m_is_malformed = true;
+            return {this->m_buffer.data(), count_read};
+        } // next(...)
+    }; // struct frame_reader
+
+    /** Writes \p values as a single frame. */
+    template <std::floating_point t_value_type>
+    bool write_frame(std::FILE* stream, std::span<const t_value_type> values) noexcept
+    {
+        frame_header header{};
+        header.count = static_cast<std::uint32_t>(values.size());
+        if (std::fwrite(&header, sizeof(frame_header), 1, stream) != 1) return false;
+        return std::fwrite(values.data(), sizeof(t_value_type), values.size(), stream) == values.size();
+    } // write_frame(...)
+} // namespace ropufu::sequential::online_detector
+
+#endif // ROPUFU_SEQUENTIAL_ONLINE_DETECTOR_FRAME_HPP_INCLUDED
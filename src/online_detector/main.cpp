@@ -0,0 +1,268 @@
+
+#include <nlohmann/json.hpp>
+#include <ropufu/noexcept_json.hpp>
+
+#include <ropufu/random/standard_normal_sampler_512.hpp>
+#include <ropufu/sequential/iid_process.hpp>
+
+#include "detector.hpp"
+#include "detector_config.hpp"
+#include "frame.hpp"
+
+#include <algorithm>    // std::sort
+#include <chrono>       // std::chrono::steady_clock, std::chrono::duration_cast
+#include <cstddef>      // std::size_t
+#include <cstdint>      // std::int64_t
+#include <cstdio>       // std::FILE, std::fopen, std::fclose, std::snprintf, std::fwrite, std::fflush
+#include <exception>    // std::exception
+#include <filesystem>   // std::filesystem::path
+#include <fstream>      // std::ifstream
+#include <ios>          // std::ios_base::failure
+#include <iostream>     // std::cout, std::cerr, std::endl
+#include <random>       // std::mt19937_64, std::seed_seq
+#include <span>         // std::span
+#include <string>       // std::string, std::stoull, std::stod
+#include <string_view>  // std::string_view
+#include <vector>       // std::vector
+
+#ifdef _WIN32
+#include <fcntl.h> // _O_BINARY
+#include <io.h>    // _setmode, _fileno
+#endif
+
+enum struct execution_result : int
+{
+    all_good = 0,
+    failed_to_read_config_file = 1,
+    failed_to_open_stream = 2,
+    malformed_stream = 3,
+    invalid_arguments = 4,
+    failed_to_parse_config_file = 7
+}; // struct execution_result
+
+void separator()
+{
+    std::cout << "======================================================================" << std::endl;
+} // separator(...)
+
+/** Writes every decision as a text line and flushes immediately. */
+template <typename t_detector_type>
+struct decision_printer
+{
+    using detector_type = t_detector_type;
+    using stopping_time_type = typename detector_type::stopping_time_type;
+
+    std::FILE* stream = nullptr;
+
+    void operator ()(const ropufu::sequential::gaussian_mean_hypotheses::detector_decision& decision) noexcept
+    {
+        std::string_view rule_name = detector_type::rule_names[decision.rule];
+        const char* verdict = (decision.which == stopping_time_type::decide_vertical) ? "null" : "alternative";
+
+        char line[160];
+        int length = std::snprintf(line, sizeof(line), "%zu %zu %.*s %zu %zu %s\n",
+            decision.segment, decision.time, static_cast<int>(rule_name.size()), rule_name.data(),
+            decision.row, decision.column, verdict);
+        if (length <= 0) return;
+        std::fwrite(line, 1, static_cast<std::size_t>(length), this->stream);
+        std::fflush(this->stream);
+    } // operator ()(...)
+}; // struct decision_printer
+
+/** Counts decisions without reporting them. */
+struct decision_counter
+{
+    std::size_t count = 0;
+
+    void operator ()(const ropufu::sequential::gaussian_mean_hypotheses::detector_decision& /*decision*/) noexcept
+    {
+        ++this->count;
+    } // operator ()(...)
+}; // struct decision_counter
+
+template <typename t_value_type, typename t_engine_type>
+struct program
+{
+    using type = program<t_value_type, t_engine_type>;
+    using value_type = t_value_type;
+    using engine_type = t_engine_type;
+
+    using config_type = ropufu::sequential::online_detector::detector_config<value_type>;
+    using detector_type = ropufu::sequential::gaussian_mean_hypotheses::detector<value_type>;
+    using reader_type = ropufu::sequential::online_detector::frame_reader<value_type>;
+    using sampler_type = ropufu::aftermath::random::standard_normal_sampler_512<engine_type, value_type>;
+    using process_type = ropufu::aftermath::sequential::iid_process<sampler_type>;
+
+    static bool try_read_json(const std::filesystem::path& path, nlohmann::json& j) noexcept
+    {
+        try
+        {
+            std::ifstream filestream{path}; // Try to open the file for reading.
+            if (filestream.fail()) return false; // Stop on failure.
+            filestream >> j;
+            return true;
+        } // try
+        catch (const std::ios_base::failure& /*e*/)
+        {
+            return false;
+        } // catch(...)
+    } // try_read_json(...)
+
+    static ::execution_result try_read_config(const std::filesystem::path& config_path, config_type& config) noexcept
+    {
+        nlohmann::json j{};
+        if (!type::try_read_json(config_path, j))
+        {
+            std::cout << "Failed to read config file." << std::endl;
+            return ::execution_result::failed_to_read_config_file;
+        } // if (...)
+
+        if (!ropufu::noexcept_json::try_get(j, config))
+        {
+            std::cout << "Failed to parse config file." << std::endl;
+            return ::execution_result::failed_to_parse_config_file;
+        } // if (...)
+
+        return ::execution_result::all_good;
+    } // try_read_config(...)
+
+    /** Reads framed observations from stdin and writes decisions to stdout. */
+    static ::execution_result stream(const config_type& config) noexcept
+    {
+#ifdef _WIN32
+        ::_setmode(::_fileno(stdin), _O_BINARY);
+#endif
+        detector_type detector{config.model, config.asprt_thresholds, config.gsprt_thresholds};
+        reader_type reader{stdin, config.frame_capacity};
+        ::decision_printer<detector_type> printer{stdout};
+
+        for (std::span<const value_type> chunk = reader.next(); !chunk.empty(); chunk = reader.next())
+            for (value_type x : chunk) detector.observe(x, printer);
+
+        return reader.is_malformed() ? ::execution_result::malformed_stream : ::execution_result::all_good;
+    } // stream(...)
+
+    /** Writes a recording of \p count_observations noisy observations of signal strength \p signal_strength. */
+    static ::execution_result generate(const config_type& config, const std::filesystem::path& recording_path,
+        std::size_t count_observations, value_type signal_strength) noexcept
+    {
+        std::FILE* recording = std::fopen(recording_path.string().c_str(), "wb");
+        if (recording == nullptr) return ::execution_result::failed_to_open_stream;
+
+        int time_seed = static_cast<int>(std::chrono::system_clock::now().time_since_epoch().count());
+        std::seed_seq sequence{ 1, 1, 2, 3, 5, 8, 1729, time_seed };
+        process_type noise{};
+        noise.seed(sequence);
+
+        using observation_container_type = typename process_type::container_type;
+        observation_container_type block = observation_container_type(config.frame_capacity);
+        std::vector<value_type> frame(config.frame_capacity);
+        std::size_t time = 0;
+        bool is_good = true;
+        while (is_good && time < count_observations)
+        {
+            std::size_t count = count_observations - time;
+            if (count > frame.size()) count = frame.size();
+            noise.next(block);
+            for (std::size_t k = 0; k < count; ++k) frame[k] = block[k] + signal_strength * config.model.signal_at(++time);
+            is_good = ropufu::sequential::online_detector::write_frame<value_type>(recording, {frame.data(), count});
+        } // while (...)
+
+        std::fclose(recording);
+        return is_good ? ::execution_result::all_good : ::execution_result::failed_to_open_stream;
+    } // generate(...)
+
+    /** Replays a recording, reporting throughput and per-observation latency. */
+    static ::execution_result benchmark(const config_type& config, const std::filesystem::path& recording_path) noexcept
+    {
+        using clock_type = std::chrono::steady_clock;
+
+        std::FILE* recording = std::fopen(recording_path.string().c_str(), "rb");
+        if (recording == nullptr) return ::execution_result::failed_to_open_stream;
+        std::vector<value_type> observations{};
+        reader_type reader{recording, config.frame_capacity};
+        for (std::span<const value_type> chunk = reader.next(); !chunk.empty(); chunk = reader.next())
+            observations.insert(observations.end(), chunk.begin(), chunk.end());
+        std::fclose(recording);
+        if (reader.is_malformed()) return ::execution_result::malformed_stream;
+        if (observations.empty()) return ::execution_result::all_good;
+
+        // Throughput: untimed observations.
+        detector_type detector{config.model, config.asprt_thresholds, config.gsprt_thresholds};
+        ::decision_counter counter{};
+        clock_type::time_point start = clock_type::now();
+        for (value_type x : observations) detector.observe(x, counter);
+        clock_type::time_point end = clock_type::now();
+        double elapsed_seconds = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count() / static_cast<double>(1'000'000'000);
+
+        // Latency: every observation timed individually, on a fresh detector.
+        std::vector<std::int64_t> latencies(observations.size());
+        detector_type latency_detector{config.model, config.asprt_thresholds, config.gsprt_thresholds};
+        ::decision_counter latency_counter{};
+        for (std::size_t k = 0; k < observations.size(); ++k)
+        {
+            clock_type::time_point before = clock_type::now();
+            latency_detector.observe(observations[k], latency_counter);
+            clock_type::time_point after = clock_type::now();
+            latencies[k] = std::chrono::duration_cast<std::chrono::nanoseconds>(after - before).count();
+        } // for (...)
+        std::sort(latencies.begin(), latencies.end());
+        auto percentile = [&latencies] (double p) {
+            return latencies[static_cast<std::size_t>(p * static_cast<double>(latencies.size() - 1))];
+        };
+
+        ::separator();
+        std::cout << "Observations: " << observations.size() << std::endl;
+        std::cout << "Segments: " << detector.count_segments() << std::endl;
+        std::cout << "Throughput: " << (observations.size() / elapsed_seconds) << " observations per second." << std::endl;
+        std::cout << "Latency (ns): p50 = " << percentile(0.5) <<
+            ", p99 = " << percentile(0.99) <<
+            ", p99.9 = " << percentile(0.999) <<
+            ", max = " << latencies.back() << std::endl;
+        ::separator();
+        return ::execution_result::all_good;
+    } // benchmark(...)
+
+    /** @brief Usage:
+     *  detector.out [config]                                              Streams stdin to stdout.
+     *  detector.out --generate <recording> <count> <signal strength> [config]  Writes a recording.
+     *  detector.out --benchmark <recording> [config]                      Replays a recording.
+     */
+    static ::execution_result execute(int argc, char* argv[]) noexcept
+    {
+        std::filesystem::path config_path = "./config.json";
+        std::string_view mode = (argc > 1) ? argv[1] : "";
+        int count_mode_arguments = 0;
+        if (mode == "--generate") count_mode_arguments = 4;
+        else if (mode == "--benchmark") count_mode_arguments = 2;
+        if (argc < count_mode_arguments + 1) return ::execution_result::invalid_arguments;
+        if (argc > count_mode_arguments + 1) config_path = argv[count_mode_arguments + 1];
+
+        config_type config{};
+        ::execution_result result = type::try_read_config(config_path, config);
+        if (result != ::execution_result::all_good) return result;
+        // Decisions go to standard output, so the warning goes to the error stream.
+        if (config.model.horizon() != 0) std::cerr << "Signal is only known for " << config.model.horizon() <<
+            " observations; longer segments repeat it." << std::endl;
+
+        try
+        {
+            if (mode == "--generate") return type::generate(config, argv[2], std::stoull(argv[3]), static_cast<value_type>(std::stod(argv[4])));
+            if (mode == "--benchmark") return type::benchmark(config, argv[2]);
+        } // try
+        catch (const std::exception& /*e*/)
+        {
+            return ::execution_result::invalid_arguments;
+        } // catch (...)
+        return type::stream(config);
+    } // execute(...)
+}; // struct program
+
+int main(int argc, char* argv[])
+{
+    using value_type = double;
+    using engine_type = std::mt19937_64;
+
+    ::execution_result result = ::program<value_type, engine_type>::execute(argc, argv);
+    return static_cast<int>(result);
+} // main(...)